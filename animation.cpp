@@ -0,0 +1,121 @@
+/*******************************************************************
+    Birthday Shader 2025 - the timeline, evaluated once per frame
+*******************************************************************/
+#include "animation.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+const char* easingNames[] = { "linear", "cubic-out", "hold" };
+
+bool parseFloat(const std::string& text, float& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtof(text.c_str(), &end);
+    return *end == '\0';
+}
+
+bool parseEasing(const std::string& text, Easing& easing) {
+    for (int i = 0; i < 3; i++) {
+        if (text == easingNames[i]) {
+            easing = static_cast<Easing>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+float Curve::evaluate(float time) const {
+    if (time <= keys.front().time) {
+        return keys.front().value;
+    }
+    for (size_t i = 1; i < keys.size(); i++) {
+        if (time < keys[i].time) {
+            const Keyframe& from = keys[i - 1];
+            const Keyframe& to = keys[i];
+            float t = (time - from.time) / (to.time - from.time);
+            switch (from.easing) {
+            case EASE_OUT_CUBIC:    return from.value + (to.value - from.value) * easeOutCubic(t);
+            case EASE_HOLD:         return from.value;
+            default:                return from.value + (to.value - from.value) * t;
+            }
+        }
+    }
+    return keys.back().value;
+}
+
+float Timeline::end() const {
+    return scale.keys.back().time;
+}
+
+bool parseTimeline(const std::string& text, const std::string& name, Timeline& timeline, std::string& error) {
+    Timeline parsed;
+    std::stringstream stream(text);
+    std::string line;
+    for (int lineNumber = 1; std::getline(stream, line); lineNumber++) {
+        line = line.substr(0, line.find('#'));
+        std::stringstream fields(line);
+        std::string curve, time, value, easing, extra;
+        if (!(fields >> curve)) {
+            continue;                       // Blank or comment
+        }
+
+        std::string where = name + ":" + std::to_string(lineNumber) + ": ";
+        if (!(fields >> time >> value) || (fields >> easing >> extra)) {
+            error = where + "expected curve time value [ease]";
+            return false;
+        }
+        if (curve != "scale") {
+            error = where + "no curve '" + curve + "' (there is scale)";
+            return false;
+        }
+        Keyframe key;
+        key.easing = EASE_LINEAR;
+        if (!parseFloat(time, key.time) || !parseFloat(value, key.value)) {
+            error = where + "bad number";
+            return false;
+        }
+        if (!easing.empty() && !parseEasing(easing, key.easing)) {
+            error = where + "ease is linear, cubic-out or hold, not '" + easing + "'";
+            return false;
+        }
+        std::vector<Keyframe>& keys = parsed.scale.keys;
+        if (!keys.empty() && (key.time <= keys.back().time)) {
+            error = where + "keyframes of a curve go in order of time";
+            return false;
+        }
+        keys.push_back(key);
+    }
+    if (parsed.scale.keys.empty()) {
+        error = name + ": no scale keyframes";
+        return false;
+    }
+    timeline = parsed;
+    return true;
+} // parseTimeline
+
+bool loadTimeline(const std::string& path, Timeline& timeline, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "Failed to open timeline: " + path;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return parseTimeline(buffer.str(), path, timeline, error);
+}
+
+void animateFrame(const Timeline& timeline, const LetterTable& table, float iTime, FrameAnimation& frame) {
+    frame = FrameAnimation();               // Offsets past the table's letters stay zero
+    frame.uScale = timeline.scale.evaluate(iTime);
+    frame.wobble = letterWobble(iTime);
+    computeLetterOffsets(table, iTime, frame.offsets);
+}
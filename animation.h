@@ -0,0 +1,70 @@
+/*******************************************************************
+    Birthday Shader 2025 - the timeline, evaluated once per frame
+
+    Everything that moves with time but is the same for every pixel is
+    worked out here on the CPU, once per frame, instead of by every
+    fragment: the zoom (uScale) from the keyframed curves of the
+    timeline file (birthday.timeline), and each letter's frame from the
+    letter table. Every renderer starts its frame from a
+    FrameAnimation; the GL ones upload it as one uniform block
+    (animation_block.h).
+*******************************************************************/
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include "letters.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Screw C++17 requirements just for a simple 'minmax' :-p
+inline float clamp(float val, float min, float max) {
+    return (val < min) ? min : (val > max) ? max : val;
+}
+
+inline float easeOutCubic(float t) {
+    return 1 - pow(1.0 - t, 3);
+}
+
+// How a curve gets from one keyframe to the next
+enum Easing {
+    EASE_LINEAR,
+    EASE_OUT_CUBIC,                         // easeOutCubic()
+    EASE_HOLD                               // Keeps the value until the next keyframe
+};
+
+struct Keyframe {
+    float time;                             // Seconds of iTime
+    float value;
+    Easing easing;                          // Toward the next keyframe
+};
+
+// Holds its first value before the first keyframe and its last after the last one
+struct Curve {
+    std::vector<Keyframe> keys;             // Sorted by time
+
+    float evaluate(float time) const;
+};
+
+struct Timeline {
+    Curve scale;                            // uScale
+
+    // Time of the last keyframe of any curve
+    float end() const;
+};
+
+// Read a timeline in the birthday.timeline format. On failure error says which line and why
+bool loadTimeline(const std::string& path, Timeline& timeline, std::string& error);
+bool parseTimeline(const std::string& text, const std::string& name, Timeline& timeline, std::string& error);
+
+// Per-frame values shared by every pixel
+struct FrameAnimation {
+    float uScale;
+    float wobble;                           // letterWobble()
+    LetterOffset offsets[LETTER_MAX];       // Letter i is drawn in the frame st = uv + offsets[i]
+};
+
+void animateFrame(const Timeline& timeline, const LetterTable& table, float iTime, FrameAnimation& frame);
+
+#endif // ANIMATION_H
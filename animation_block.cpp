@@ -0,0 +1,73 @@
+/*******************************************************************
+    Birthday Shader 2025 - the frame's animation as a uniform block
+*******************************************************************/
+#include "animation_block.h"
+
+#include <cmath>
+#include <cstring>
+
+AnimationBlock::~AnimationBlock() {
+    destroy();
+}
+
+void AnimationBlock::destroy() {
+    if (buffer) {
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+}
+
+bool AnimationBlock::create() {
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Data), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, ANIMATION_BLOCK_BINDING, buffer);
+    dirty = true;
+    return glGetError() == GL_NO_ERROR;
+}
+
+void AnimationBlock::setFrame(const FrameAnimation& frame, float iTime, uint32_t width, uint32_t height) {
+    Data next = data;
+    for (int i = 0; i < LETTER_MAX; i++) {
+        next.letterOffsets[i][0] = frame.offsets[i].x;
+        next.letterOffsets[i][1] = frame.offsets[i].y;
+    }
+    // rot(wobble) = mat2(cos, -sin, sin, cos)
+    float c = std::cos(frame.wobble);
+    float s = std::sin(frame.wobble);
+    next.wobble[0][0] = c;
+    next.wobble[0][1] = -s;
+    next.wobble[1][0] = s;
+    next.wobble[1][1] = c;
+    next.scale = frame.uScale;
+    next.time = iTime;
+    next.resolution[0] = static_cast<float>(width);
+    next.resolution[1] = static_cast<float>(height);
+    if (memcmp(&next, &data, sizeof(Data)) != 0) {
+        data = next;
+        dirty = true;
+    }
+}
+
+void AnimationBlock::setRandom(float uRandom) {
+    if (data.random != uRandom) {
+        data.random = uRandom;
+        dirty = true;
+    }
+}
+
+void AnimationBlock::upload() {
+    if (dirty) {
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(data), &data);
+        dirty = false;
+    }
+}
+
+void AnimationBlock::bind() const {
+    glBindBufferBase(GL_UNIFORM_BUFFER, ANIMATION_BLOCK_BINDING, buffer);
+}
+
+void AnimationBlock::bindBlock(const ShaderProgram& program) {
+    program.bindBlock("Animation", ANIMATION_BLOCK_BINDING);
+}
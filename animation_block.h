@@ -0,0 +1,70 @@
+/*******************************************************************
+    Birthday Shader 2025 - the frame's animation as a uniform block
+
+    SETUP_LETTER used to work out every letter's spiral (an exp(), a
+    sin() and a cos() or two, sometimes a pow()) and every letter
+    function its wobble rotation, at every pixel, although the answers
+    are the same across the whole frame. Now the host evaluates them
+    once per frame (animateFrame() in animation.h) and the shader
+    reads them from the std140 Animation block, uploaded in one go
+    alongside the zoom. iTime, iResolution and uRandom are in the
+    block as well, so a frame costs one buffer upload rather than a
+    call per uniform, none when nothing changed, and a new seed or
+    window size only changes what the next upload carries.
+*******************************************************************/
+#ifndef ANIMATION_BLOCK_H
+#define ANIMATION_BLOCK_H
+
+#include "animation.h"
+#include "shader_program.h"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+
+constexpr GLuint ANIMATION_BLOCK_BINDING = 0;   // Uniform buffer binding point of the Animation block
+
+class AnimationBlock {
+public:
+    AnimationBlock() = default;
+    ~AnimationBlock();
+
+    AnimationBlock(const AnimationBlock&) = delete;
+    AnimationBlock& operator=(const AnimationBlock&) = delete;
+
+    // Needs a current context. Leaves the buffer bound to ANIMATION_BLOCK_BINDING
+    bool create();
+    void destroy();
+
+    // The frame about to be drawn and the seed, kept until upload()
+    void setFrame(const FrameAnimation& frame, float iTime, uint32_t width, uint32_t height);
+    void setRandom(float uRandom);
+
+    // Send the block to the buffer if anything in it changed since the last upload
+    void upload();
+
+    // Put the buffer back on ANIMATION_BLOCK_BINDING, after other GL code may have used the binding point
+    void bind() const;
+
+    // Attach the program's Animation block to the binding point (harmless for programs without it)
+    static void bindBlock(const ShaderProgram& program);
+
+private:
+    // The Animation block of birthday.shader in std140 layout: every array element and matrix column
+    // takes a whole vec4, and a vec2 starts on an 8-byte boundary
+    struct Data {
+        float letterOffsets[LETTER_MAX][4]; // vec4 uLetterOffset[LETTER_MAX], .xy used
+        float wobble[2][4];                 // mat2 uWobble, column by column
+        float scale;                        // float uScale
+        float time;                         // float iTime
+        float resolution[2];                // vec2 iResolution
+        float random;                       // float uRandom
+        float padding[3];                   // To the block's vec4 size
+    };
+
+    GLuint buffer = 0;
+    Data data = {};
+    bool dirty = true;                      // data differs from what the buffer holds
+};
+
+#endif // ANIMATION_BLOCK_H
@@ -0,0 +1,38 @@
+/*******************************************************************
+    Birthday Shader 2025 - edge-adaptive anti-aliasing
+*******************************************************************/
+#include "antialias.h"
+
+#include <cstring>
+
+namespace {
+
+const char* modeNames[] = { "off", "edge", "full" };
+
+} // namespace
+
+bool parseAntialiasMode(const char* name, AntialiasMode& mode) {
+    for (int i = 0; i < 3; i++) {
+        if (strcmp(name, modeNames[i]) == 0) {
+            mode = static_cast<AntialiasMode>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* antialiasModeName(AntialiasMode mode) {
+    return modeNames[mode];
+}
+
+const char* antialiasShaderDefines(AntialiasMode mode) {
+    switch (mode) {
+    case ANTIALIAS_EDGE: return "#define AA_EDGE\n";
+    case ANTIALIAS_FULL: return "#define AA_FULL\n";
+    default: return "";
+    }
+}
+
+const char* antialiasCountDefines() {
+    return "#define AA_EDGE\n#define AA_EDGE_COUNT\n";
+}
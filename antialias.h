@@ -0,0 +1,35 @@
+/*******************************************************************
+    Birthday Shader 2025 - edge-adaptive anti-aliasing
+
+    The letters' outlines are smoothsteps a hundredth of uv wide, under
+    a pixel once the camera has pulled out, so they shimmer; more so on
+    high-DPI screens. Multisampling the one full-screen quad would run
+    the whole fragment shader several times for every pixel. With
+    --aa edge the shader takes four more samples of the letters, and
+    only of the letters, where they change colour between neighbouring
+    pixels, which is a few percent of the screen; the background and
+    the letter interiors stay at one sample. --aa full supersamples
+    every pixel the same way and is the reference --bench --aa all
+    measures the other two against, along with the fraction of pixels
+    edge mode supersamples.
+*******************************************************************/
+#ifndef ANTIALIAS_H
+#define ANTIALIAS_H
+
+enum AntialiasMode {
+    ANTIALIAS_OFF,                          // One sample per pixel (the original)
+    ANTIALIAS_EDGE,                         // AA_EDGE: five samples of the letters near their edges
+    ANTIALIAS_FULL                          // AA_FULL: five samples of the letters everywhere
+};
+constexpr AntialiasMode ANTIALIAS_DEFAULT = ANTIALIAS_OFF;
+
+bool parseAntialiasMode(const char* name, AntialiasMode& mode);
+const char* antialiasModeName(AntialiasMode mode);
+
+// Lines for insertDefines()
+const char* antialiasShaderDefines(AntialiasMode mode);
+
+// Added to an edge program's defines, it discards all but the pixels that get supersampled
+const char* antialiasCountDefines();
+
+#endif // ANTIALIAS_H
@@ -0,0 +1,41 @@
+/***************************** Background functions *****************************/
+
+// Based on code from https://www.shadertoy.com/view/wdyczG
+
+// The host can render the background ahead in its own pass at a fraction of the resolution
+// (background_layer.cpp): that pass defines BACKGROUND_PASS and NOISE_TEXTURE, where noise() reads
+// a baked table, and the main pass defines BACKGROUND_TEXTURE and samples the result
+#include "noise.glsl"
+#ifdef BACKGROUND_TEXTURE
+uniform sampler2D uBackground;
+#endif
+
+vec3 drawBackground() {
+    vec2 uv = (fragCoord/iResolution.xy) - 0.5;
+    float ratio = iResolution.x / iResolution.y;
+
+    // rotate with Noise (and use provided random seed and a 'special number')
+    MP float degree = noise(vec2((iTime + (uRandom * 2002.411)) * 0.08, uv.x*uv.y));
+
+    uv.y *= 1./ratio;
+    uv *= rot(radians((degree-.5)*720.+180.));
+	uv.y *= ratio;
+
+    // Wave warp with sin
+    float frequency = 5.;
+    float amplitude = 30.;
+    float speed = iTime * 2.;
+    uv.x += sin(uv.y*frequency+speed)/amplitude;
+   	uv.y += sin(uv.x*frequency*1.5+speed)/(amplitude*.5);
+    
+    // draw the image
+    vec3 colorYellow = vec3(.957, .804, .623);
+    vec3 colorDeepBlue = vec3(.192, .384, .933);
+    MP vec3 layer1 = H(mix(colorYellow, colorDeepBlue, S(-.3, .2, (uv*rot(radians(-5.))).x)));
+    
+    vec3 colorRed = vec3(.910, .510, .8);
+    vec3 colorBlue = vec3(0.350, .71, .953);
+    MP vec3 layer2 = H(mix(colorRed, colorBlue, S(-.3, .2, (uv*rot(radians(-5.))).x)));
+    
+    return H(mix(layer1, layer2, S(.5, -.3, uv.y)));
+} // drawBackground
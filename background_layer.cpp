@@ -0,0 +1,241 @@
+/*******************************************************************
+    Birthday Shader 2025 - reduced-rate background layer
+*******************************************************************/
+#include "background_layer.h"
+#include "animation_block.h"
+#include "gl_common.h"
+#include "program_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// No letters in this pass, so no letter table either
+const char* backgroundPassDefines = "#define BACKGROUND_PASS\n#define NOISE_TEXTURE\n#define LETTER_BLOCKS\n";
+const char* modeNames[] = { "inline", "layer" };
+
+// hash() of noise.glsl in single precision, as the GPU runs it: sin() of numbers this large
+// scaled by 43758 is all rounding, so doing it in double would give a different (equally random) table
+void hash(double x, double y, double& hx, double& hy) {
+    float px = static_cast<float>(x) * 2127.1f + static_cast<float>(y) * 81.17f;
+    float py = static_cast<float>(x) * 1269.5f + static_cast<float>(y) * 283.37f;
+    float sx = std::sin(px) * 43758.5453f;
+    float sy = std::sin(py) * 43758.5453f;
+    hx = sx - std::floor(sx);
+    hy = sy - std::floor(sy);
+}
+
+double gradient(double cellX, double cellY, double fx, double fy) {
+    double hx, hy;
+    hash(cellX, cellY, hx, hy);
+    return (-1.0 + 2.0 * hx) * fx + (-1.0 + 2.0 * hy) * fy;
+}
+
+double noise(double x, double y) {
+    double ix = std::floor(x), iy = std::floor(y);
+    double fx = x - ix, fy = y - iy;
+    double ux = fx * fx * (3.0 - 2.0 * fx);
+    double uy = fy * fy * (3.0 - 2.0 * fy);
+    double bottom = gradient(ix, iy, fx, fy) + (gradient(ix + 1.0, iy, fx - 1.0, fy) - gradient(ix, iy, fx, fy)) * ux;
+    double top = gradient(ix, iy + 1.0, fx, fy - 1.0) +
+        (gradient(ix + 1.0, iy + 1.0, fx - 1.0, fy - 1.0) - gradient(ix, iy + 1.0, fx, fy - 1.0)) * ux;
+    return 0.5 + 0.5 * (bottom + (top - bottom) * uy);
+}
+
+} // namespace
+
+bool parseBackgroundMode(const char* name, BackgroundMode& mode) {
+    for (int i = 0; i < 2; i++) {
+        if (strcmp(name, modeNames[i]) == 0) {
+            mode = static_cast<BackgroundMode>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* backgroundModeName(BackgroundMode mode) {
+    return modeNames[mode];
+}
+
+const char* backgroundShaderDefines(BackgroundMode mode) {
+    return (mode == BACKGROUND_LAYER) ? "#define BACKGROUND_TEXTURE\n" : "";
+}
+
+void bakeNoise(int32_t originCell, std::vector<float>& texels) {
+    const uint32_t columns = NOISE_CELLS * NOISE_CELL_SAMPLES;
+    texels.resize(size_t(columns) * NOISE_ROWS);
+    for (uint32_t row = 0; row < NOISE_ROWS; row++) {
+        double y = -0.25 + (row + 0.5) * (0.5 / NOISE_ROWS);
+        for (uint32_t column = 0; column < columns; column++) {
+            double x = originCell + (column + 0.5) / NOISE_CELL_SAMPLES;
+            texels[row * columns + column] = static_cast<float>(noise(x, y));
+        }
+    }
+}
+
+float backgroundNoiseX(float iTime, float uRandom) {
+    return (iTime + uRandom * 2002.411f) * 0.08f;
+}
+
+/***************************** BackgroundLayer *****************************/
+
+BackgroundLayer::~BackgroundLayer() {
+    destroy();
+}
+
+void BackgroundLayer::destroy() {
+    if (program.id()) {
+        program.destroy();
+        glDeleteShader(fragmentShader);
+        fragmentShader = 0;
+    }
+    if (noiseTexture) {
+        glDeleteTextures(1, &noiseTexture);
+        noiseTexture = 0;
+        noiseBaked = false;
+    }
+    if (framebuffer) {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteTextures(1, &texture);
+        framebuffer = texture = 0;
+    }
+    width = height = 0;
+}
+
+bool BackgroundLayer::create(const std::string& shaderSource, GLuint vs, float layerScale, std::ostream& log,
+                             std::string& error) {
+    scale = layerScale;
+    vertexShader = vs;
+    std::string source = insertDefines(shaderSource, backgroundPassDefines);
+    program.reset(loadOrBuildProgram(vertexShaderSource, vertexShader, source, fragmentShader, log, error));
+    if (!program.id()) {
+        return false;
+    }
+    setupProgram();
+    glGenTextures(1, &noiseTexture);        // Baked by the first render(), around that frame's cells
+    return (program.id() != 0) && (noiseTexture != 0);
+}
+
+void BackgroundLayer::bakeNoiseTexture(int32_t originCell) {
+    std::vector<float> texels;
+    bakeNoise(originCell, texels);
+    glActiveTexture(GL_TEXTURE0 + NOISE_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, noiseTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, NOISE_CELLS * NOISE_CELL_SAMPLES, NOISE_ROWS, 0, GL_RED, GL_FLOAT,
+                 texels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glActiveTexture(GL_TEXTURE0);
+    noiseOrigin = originCell;
+    noiseBaked = true;
+
+    GLint current = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+    program.use();
+    glUniform1f(program.location("uNoiseOrigin"), static_cast<float>(noiseOrigin));
+    glUseProgram(current);
+}
+
+void BackgroundLayer::setupProgram() {
+    GLint current = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+    program.use();
+    AnimationBlock::bindBlock(program);
+    program.setSampler("uNoise", NOISE_TEXTURE_UNIT);
+    glUniform1f(program.location("uNoiseOrigin"), static_cast<float>(noiseOrigin));
+    glUseProgram(current);
+}
+
+bool BackgroundLayer::rebuild(const std::string& shaderSource, std::string& error) {
+    std::string source = insertDefines(shaderSource, backgroundPassDefines);
+    const char* text = source.c_str();
+    GLuint shader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(shader, 1, &text, nullptr);
+    glCompileShader(shader);
+    if (!shaderCompiled(shader, error)) {
+        glDeleteShader(shader);
+        return false;
+    }
+    GLuint built = linkProgram(vertexShader, shader);
+    if (!programLinked(built, error)) {
+        glDeleteProgram(built);
+        glDeleteShader(shader);
+        return false;
+    }
+    glDeleteShader(fragmentShader);
+    program.reset(built);
+    fragmentShader = shader;
+    setupProgram();
+    return true;
+}
+
+bool BackgroundLayer::resize(uint32_t w, uint32_t h) {
+    if (!texture) {
+        glGenTextures(1, &texture);
+        glGenFramebuffers(1, &framebuffer);
+    }
+    width = w;
+    height = h;
+
+    // Linear filtering does the upscale when the main pass samples it
+    glActiveTexture(GL_TEXTURE0 + BACKGROUND_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+void BackgroundLayer::render(uint32_t frameWidth, uint32_t frameHeight, float iTime, float uRandom) {
+    // The frame reads the lattice cells at floor(x) and floor(x) + 1; bake them again with a cell to spare on
+    // either side once x is within a cell of the table's edges, which at 0.08 cells a second is every 12 minutes
+    // or when the timeline jumps
+    float x = backgroundNoiseX(iTime, uRandom);
+    if (!noiseBaked || (x < noiseOrigin + 1.0f) || (x > noiseOrigin + float(NOISE_CELLS) - 2.0f)) {
+        bakeNoiseTexture(static_cast<int32_t>(std::floor(x)) - 1);
+    }
+
+    GLint previousFramebuffer = 0;
+    GLint viewport[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    uint32_t layerWidth = std::max(1u, static_cast<uint32_t>(frameWidth * scale + 0.5f));
+    uint32_t layerHeight = std::max(1u, static_cast<uint32_t>(frameHeight * scale + 0.5f));
+    if ((layerWidth != width) || (layerHeight != height)) {
+        resize(layerWidth, layerHeight);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, layerWidth, layerHeight);
+
+    // iTime, uRandom and iResolution come from the main pass's Animation block: with the main pass's size,
+    // fragCoord spans the same range it does there
+    program.use();
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+void BackgroundLayer::bind() const {
+    glActiveTexture(GL_TEXTURE0 + BACKGROUND_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glActiveTexture(GL_TEXTURE0 + NOISE_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, noiseTexture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void BackgroundLayer::bindSampler(const ShaderProgram& program) {
+    program.setSampler("uBackground", BACKGROUND_TEXTURE_UNIT);
+}
@@ -0,0 +1,99 @@
+/*******************************************************************
+    Birthday Shader 2025 - reduced-rate background layer
+
+    The background is a smooth, low-frequency gradient, yet the single
+    pass runs its hash noise, rotation and sine warp at every pixel of
+    every frame. Here it gets a pass of its own into a texture at a
+    fraction of the frame's size (half by default) and the main pass
+    just samples it before drawing the letters. That pass also swaps
+    the sin() hash noise for a lookup into a table baked around the
+    lattice cells the animation is at, and baked again every few
+    minutes as it moves on. --background inline goes back to the single pass and
+    --bench --background both compares the two against each other.
+*******************************************************************/
+#ifndef BACKGROUND_LAYER_H
+#define BACKGROUND_LAYER_H
+
+#include "shader_program.h"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+constexpr float BACKGROUND_DEFAULT_SCALE = 0.5f;   // Of the main pass's width and height
+constexpr uint32_t NOISE_CELLS = 64;            // Lattice cells along x in the table; as in noise.glsl
+constexpr uint32_t NOISE_CELL_SAMPLES = 16;     // Table columns per lattice cell
+constexpr uint32_t NOISE_ROWS = 32;             // Over y in [-.25, .25]
+constexpr GLint BACKGROUND_TEXTURE_UNIT = 3;    // After the upscale pass, the letter atlas and the letter tiles
+constexpr GLint NOISE_TEXTURE_UNIT = 4;
+
+enum BackgroundMode {
+    BACKGROUND_INLINE,                      // drawBackground() at every pixel of the main pass (the original)
+    BACKGROUND_LAYER
+};
+constexpr BackgroundMode BACKGROUND_DEFAULT = BACKGROUND_LAYER; // 15-20% faster on llvmpipe at ~53 dB; compare with --bench --background both
+
+bool parseBackgroundMode(const char* name, BackgroundMode& mode);
+const char* backgroundModeName(BackgroundMode mode);
+
+// Lines for insertDefines() in the main pass: BACKGROUND_TEXTURE for the layer, nothing inline
+const char* backgroundShaderDefines(BackgroundMode mode);
+
+// noise() of noise.glsl over the NOISE_CELLS lattice cells along x from originCell on, row 0 at y = -.25
+void bakeNoise(int32_t originCell, std::vector<float>& texels);
+
+// The x drawBackground() passes to noise(): the same for every pixel of a frame
+float backgroundNoiseX(float iTime, float uRandom);
+
+class BackgroundLayer {
+public:
+    BackgroundLayer() = default;
+    ~BackgroundLayer();
+
+    BackgroundLayer(const BackgroundLayer&) = delete;
+    BackgroundLayer& operator=(const BackgroundLayer&) = delete;
+
+    // Needs a current context. shaderSource is birthday.shader as loaded, without any pass defines.
+    // false with the reason in error when the pass doesn't build
+    bool create(const std::string& shaderSource, GLuint vertexShader, float scale, std::ostream& log,
+                std::string& error);
+    void destroy();
+
+    // Hot reload: build the background pass from new source, keeping the old one if it doesn't link
+    bool rebuild(const std::string& shaderSource, std::string& error);
+
+    // Draw this frame's background for a main pass of frameWidth x frameHeight with the bound full-screen quad
+    // and the frame's Animation block uploaded, iTime and uRandom being what it holds. The noise table is baked
+    // again when the frame's noise cells leave it. The framebuffer and viewport are put back afterwards; the
+    // pass's program is left in use
+    void render(uint32_t frameWidth, uint32_t frameHeight, float iTime, float uRandom);
+
+    // Bind the layer and the noise table to their units again, after other GL code may have used them
+    void bind() const;
+
+    // Point the main program's uBackground sampler at the layer, with the program in use (harmless for
+    // programs without it)
+    static void bindSampler(const ShaderProgram& program);
+
+private:
+    void setupProgram();
+    bool resize(uint32_t width, uint32_t height);
+    void bakeNoiseTexture(int32_t originCell);
+
+    float scale = BACKGROUND_DEFAULT_SCALE;
+    GLuint vertexShader = 0;
+    ShaderProgram program;
+    GLuint fragmentShader = 0;
+    GLuint framebuffer = 0;
+    GLuint texture = 0;                     // Stays bound to BACKGROUND_TEXTURE_UNIT
+    uint32_t width = 0;
+    uint32_t height = 0;
+    GLuint noiseTexture = 0;
+    int32_t noiseOrigin = 0;                // First lattice cell along x in the noise table
+    bool noiseBaked = false;
+};
+
+#endif // BACKGROUND_LAYER_H
@@ -0,0 +1,236 @@
+/*******************************************************************
+    Birthday Shader 2025 - batch stills
+*******************************************************************/
+#include "batch.h"
+#include "bench.h"
+#include "cpu_renderer.h"
+#include "gl_common.h"
+#include "headless.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+bool parseBatchJobs(const std::string& text, const std::string& name, std::vector<BatchJob>& jobs, std::string& error) {
+    std::vector<BatchJob> parsed;
+    std::stringstream stream(text);
+    std::string line;
+    for (int lineNumber = 1; std::getline(stream, line); lineNumber++) {
+        line = line.substr(0, line.find('#'));
+        std::stringstream fields(line);
+        std::string seed, size, time;
+        if (!(fields >> seed)) {
+            continue;                       // Blank or comment
+        }
+
+        std::string where = name + ":" + std::to_string(lineNumber) + ": ";
+        BatchJob job;
+        char* end = nullptr;
+        unsigned long value = strtoul(seed.c_str(), &end, 10);
+        if ((*end != '\0') || (value > 0xffffffffUL)) {
+            error = where + "bad seed '" + seed + "'";
+            return false;
+        }
+        job.seed = static_cast<uint32_t>(value);
+        std::vector<BenchResolution> resolution;
+        if (!(fields >> size) || (size.find(',') != std::string::npos) || !parseResolutionList(size.c_str(), resolution)) {
+            error = where + "expected seed WIDTHxHEIGHT time...";
+            return false;
+        }
+        job.width = resolution[0].width;
+        job.height = resolution[0].height;
+        while (fields >> time) {
+            float seconds = strtof(time.c_str(), &end);
+            if ((*end != '\0') || !(seconds >= 0.0f)) {
+                error = where + "bad time '" + time + "'";
+                return false;
+            }
+            job.times.push_back(seconds);
+        }
+        if (job.times.empty()) {
+            error = where + "no time points";
+            return false;
+        }
+        parsed.push_back(job);
+    }
+    if (parsed.empty()) {
+        error = name + ": no jobs";
+        return false;
+    }
+    jobs = parsed;
+    return true;
+} // parseBatchJobs
+
+bool loadBatchJobs(const std::string& path, std::vector<BatchJob>& jobs, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "Failed to open job list: " + path;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return parseBatchJobs(buffer.str(), path, jobs, error);
+}
+
+namespace {
+
+struct BatchImage {
+    const BatchJob* job;
+    float time;
+    uint32_t index;                         // In the whole list, so time points closer than the name shows differ
+};
+
+// What the workers share: the next image to take, the tally, and one lock for setup and the log
+struct BatchState {
+    const BatchOptions* options;
+    std::vector<BatchImage> images;
+    std::string shaderSource;               // GL only
+    std::atomic<uint32_t> next{0};
+    std::atomic<uint32_t> written{0};
+    std::atomic<uint32_t> failed{0};
+    std::mutex mutex;
+    bool glewReady = false;                 // GLEW's entry points are process-wide: load them once
+};
+
+std::string imagePath(const BatchOptions& options, const BatchImage& image) {
+    char name[128];
+    snprintf(name, sizeof(name), "%04u_seed%u_%ux%u_t%.2f.%s", image.index, image.job->seed, image.job->width,
+             image.job->height, image.time, imageFormatName(options.format));
+    if (options.outputDirectory.empty()) {
+        return name;
+    }
+    char last = options.outputDirectory.back();
+    return options.outputDirectory + (((last == '/') || (last == '\\')) ? "" : "/") + name;
+}
+
+void finishImage(BatchState& state, const BatchImage& image, const std::vector<uint8_t>& pixels, bool bottomUp) {
+    std::string path = imagePath(*state.options, image);
+    if (writeImage(path, state.options->format, pixels.data(), image.job->width, image.job->height, bottomUp)) {
+        state.written++;
+    } else {
+        state.failed++;
+        std::lock_guard<std::mutex> lock(state.mutex);
+        std::cerr << "Failed to write image: " << path << std::endl;
+    }
+}
+
+void cpuWorker(BatchState& state) {
+    const BatchOptions& options = *state.options;
+    CpuRenderer renderer(1, options.allowSIMD);    // The images are the parallelism here, not the tiles
+    std::vector<uint8_t> pixels;
+    for (uint32_t index; (index = state.next++) < state.images.size(); ) {
+        const BatchImage& image = state.images[index];
+        pixels.resize(size_t(image.job->width) * image.job->height * 4);
+        FrameAnimation animation;
+        animateFrame(options.scene.timeline, options.scene.message, image.time, animation);
+        FrameUniforms uniforms;
+        uniforms.iResolution[0] = static_cast<float>(image.job->width);
+        uniforms.iResolution[1] = static_cast<float>(image.job->height);
+        uniforms.iTime = image.time;
+        uniforms.uRandom = seedRandom(image.job->seed);
+        uniforms.letters = &options.scene.message;
+        uniforms.animation = &animation;
+        renderer.render(uniforms, pixels.data());
+        finishImage(state, image, pixels, false);
+    }
+}
+
+void glWorker(BatchState& state) {
+    const BatchOptions& options = *state.options;
+    HeadlessContext context;
+    Scene scene;
+    {
+        // One context at a time: the program cache and GLEW aren't made for concurrent setup
+        std::lock_guard<std::mutex> lock(state.mutex);
+        std::string error;
+        if (!context.create(error)) {
+            std::cerr << "Failed to create headless OpenGL context: " << error << std::endl;
+            return;
+        }
+        if (!state.glewReady && !initGLEW()) {
+            std::cerr << "Failed to initialize GLEW" << std::endl;
+            return;
+        }
+        state.glewReady = true;
+        if (!scene.create(options.scene, state.shaderSource, std::cout, error)) {
+            std::cerr << error << std::endl;
+            return;
+        }
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    // Only remade when the size changes; a job's time points all share it
+    OffscreenTarget target;
+    std::vector<uint8_t> pixels;
+    for (uint32_t index; (index = state.next++) < state.images.size(); ) {
+        const BatchImage& image = state.images[index];
+        uint32_t width = image.job->width, height = image.job->height;
+        if ((target.width != width) || (target.height != height) || !target.framebuffer) {
+            if (!target.create(width, height)) {
+                state.failed++;
+                std::lock_guard<std::mutex> lock(state.mutex);
+                std::cerr << "Failed to create " << width << "x" << height << " framebuffer" << std::endl;
+                continue;
+            }
+            target.bind();
+            pixels.resize(size_t(width) * height * 4);
+        }
+
+        scene.setRandom(seedRandom(image.job->seed));
+        scene.render(image.time, width, height);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        finishImage(state, image, pixels, true);
+    }
+
+    target.destroy();
+    scene.destroy();
+} // glWorker
+
+} // namespace
+
+int runBatchMode(const BatchOptions& options) {
+    BatchState state;
+    state.options = &options;
+    for (const BatchJob& job : options.jobs) {
+        for (float time : job.times) {
+            state.images.push_back({ &job, time, static_cast<uint32_t>(state.images.size()) });
+        }
+    }
+    if (!options.cpu) {
+        state.shaderSource = loadShaderSource(options.shaderPath);
+    }
+
+    uint32_t workers = options.workers;
+    if (workers == 0) {
+        workers = options.cpu ? std::max(1u, std::thread::hardware_concurrency()) : BATCH_DEFAULT_CONTEXTS;
+    }
+    workers = std::min(workers, static_cast<uint32_t>(state.images.size()));
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < workers; i++) {
+        threads.emplace_back(options.cpu ? cpuWorker : glWorker, std::ref(state));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint32_t written = state.written;
+    uint32_t failed = state.failed;
+    std::cout << "Rendered " << written << " of " << state.images.size() << " images with " << workers <<
+        (options.cpu ? " CPU workers" : " GL contexts") << " in " << seconds << " s (" << written / seconds <<
+        " images/s)" << std::endl;
+    if (written + failed < state.images.size()) {
+        std::cerr << "Not every worker could start; " << state.images.size() - written - failed << " images not rendered"
+                  << std::endl;
+    }
+    return (written == state.images.size()) ? 0 : 1;
+} // runBatchMode
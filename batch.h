@@ -0,0 +1,51 @@
+/*******************************************************************
+    Birthday Shader 2025 - batch stills
+
+    Renders a job list (birthday.batch format: seed, size, one or more
+    times) to one image per time point, for preview sheets of many
+    variations at once. Jobs are shared out over several workers, each
+    with its own headless GL context and one program compiled for it
+    (or, with --cpu, its own single-threaded CPU renderer). A worker
+    keeps only the frame it is working on and writes it out before
+    taking the next, so memory stays at one image per worker however
+    long the list is. A seed gives the same uRandom as --seed does, so
+    any image can be rendered again on its own with --headless.
+*******************************************************************/
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "image_io.h"
+#include "scene.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+constexpr uint32_t BATCH_DEFAULT_CONTEXTS = 2;  // GL workers; the driver has threads of its own
+
+struct BatchJob {
+    uint32_t seed;
+    uint32_t width;
+    uint32_t height;
+    std::vector<float> times;               // iTime of each image
+};
+
+// Read a job list in the birthday.batch format. On failure error says which line and why
+bool loadBatchJobs(const std::string& path, std::vector<BatchJob>& jobs, std::string& error);
+bool parseBatchJobs(const std::string& text, const std::string& name, std::vector<BatchJob>& jobs, std::string& error);
+
+struct BatchOptions {
+    std::vector<BatchJob> jobs;
+    std::string outputDirectory;            // Current directory if empty
+    ImageFormat format = IMAGE_PNG;
+    bool cpu = false;                       // CPU renderer instead of headless GL contexts
+    uint32_t workers = 0;                   // 0: BATCH_DEFAULT_CONTEXTS, or every hardware thread with cpu
+    bool allowSIMD = true;
+    std::string shaderPath;                 // Built-in shader if empty
+    SceneOptions scene;                     // The CPU renderer only follows its message and timeline
+};
+
+// --batch: render every job's images and write them to outputDirectory
+int runBatchMode(const BatchOptions& options);
+
+#endif // BATCH_H
@@ -0,0 +1,518 @@
+/*******************************************************************
+    Birthday Shader 2025 - deterministic benchmark
+*******************************************************************/
+#include "bench.h"
+#include "animation_block.h"
+#include "gl_common.h"
+#include "headless.h"
+#include "program_cache.h"
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+namespace {
+
+// Milliseconds per frame for one resolution
+struct FrameTimes {
+    std::vector<double> cpu;                // Wall time of the whole frame iteration, waits included
+    std::vector<double> gpu;                // GL_TIME_ELAPSED around the draw
+};
+
+// Frames against the reference combination's, in 8-bit steps over every channel
+struct FrameError {
+    double meanAbs;
+    double max;
+    double psnr;                            // dB
+    double over2;                           // Fraction of pixels with a channel more than 2 steps off
+};
+
+struct BenchResult {
+    BenchResolution resolution;
+    LetterCode letterCode;
+    LetterMode letters;
+    BackgroundMode background;
+    AntialiasMode antialias;
+    ShaderPrecision precision;
+    FrameTimes times;
+    double seconds;                         // Wall time of the measured frames
+    bool compared;                          // error is filled in
+    FrameError error;
+    double edgeFraction;                    // Of the pixels, supersampled by --aa edge; below 0 for other modes
+};
+
+// The shader built for one combination of letter code, letter mode, background mode, anti-aliasing and precision
+struct BenchProgram {
+    LetterCode letterCode;
+    LetterMode letters;
+    BackgroundMode background;
+    AntialiasMode antialias;
+    ShaderPrecision precision;
+    std::unique_ptr<ShaderProgram> program;
+    GLuint fragmentShader;
+    std::unique_ptr<ShaderProgram> countProgram;    // Edge anti-aliasing only: draws just the supersampled pixels
+    GLuint countShader;
+};
+
+// Nearest-rank percentile of sorted values
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if ((c == '"') || (c == '\\')) {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) >= 0x20) {
+            out += c;
+        }
+    }
+    return out;
+}
+
+void writeStats(std::ostream& out, const char* name, std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (double v : values) {
+        sum += v;
+    }
+    char line[256];
+    snprintf(line, sizeof(line),
+             "\"%s\": { \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f }",
+             name, values.empty() ? 0.0 : sum / values.size(), percentile(values, 50.0), percentile(values, 95.0),
+             percentile(values, 99.0), values.empty() ? 0.0 : values.back());
+    out << line;
+}
+
+void writeReport(std::ostream& out, const BenchOptions& options, const std::string& renderer,
+                 const std::vector<BenchResult>& results) {
+    char number[64];
+    out << "{" << std::endl;
+    out << "  \"renderer\": \"" << jsonEscape(renderer) << "\"," << std::endl;
+    out << "  \"context\": \"" << (options.headless ? "egl" : "glfw") << "\"," << std::endl;
+    snprintf(number, sizeof(number), "%.6g", options.startTime);
+    out << "  \"startTime\": " << number << "," << std::endl;
+    snprintf(number, sizeof(number), "%.6g", options.endTime);
+    out << "  \"endTime\": " << number << "," << std::endl;
+    snprintf(number, sizeof(number), "%.6g", options.fps);
+    out << "  \"timestep\": \"1/" << number << "\"," << std::endl;
+    out << "  \"seed\": " << options.seed << "," << std::endl;
+    snprintf(number, sizeof(number), "%.9g", options.uRandom);
+    out << "  \"uRandom\": " << number << "," << std::endl;
+    out << "  \"warmupFrames\": " << BENCH_WARMUP_FRAMES << "," << std::endl;
+    out << "  \"letterCulling\": " << (options.letterCulling ? "true" : "false") << "," << std::endl;
+    snprintf(number, sizeof(number), "%.6g", options.backgroundScale);
+    out << "  \"backgroundScale\": " << number << "," << std::endl;
+    out << "  \"results\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        size_t frames = result.times.cpu.size();
+        snprintf(number, sizeof(number), "%.2f", frames / result.seconds);
+        out << "    {" << std::endl;
+        out << "      \"width\": " << result.resolution.width << ", \"height\": " << result.resolution.height
+            << ", \"letterCode\": \"" << letterCodeName(result.letterCode) << "\", \"letters\": \""
+            << letterModeName(result.letters) << "\", \"background\": \""
+            << backgroundModeName(result.background) << "\", \"antialias\": \"" << antialiasModeName(result.antialias)
+            << "\", \"precision\": \"" << shaderPrecisionName(result.precision) << "\", \"frames\": " << frames
+            << ", \"fps\": " << number << "," << std::endl;
+        out << "      ";
+        writeStats(out, "cpuMs", result.times.cpu);
+        out << "," << std::endl << "      ";
+        writeStats(out, "gpuMs", result.times.gpu);
+        if (result.edgeFraction >= 0.0) {
+            snprintf(number, sizeof(number), "%.6f", result.edgeFraction);
+            out << "," << std::endl << "      \"supersampled\": " << number;
+        }
+        if (result.compared) {
+            char line[256];
+            snprintf(line, sizeof(line), "\"error\": { \"reference\": \"%s/%s/%s/%s/%s\", \"samples\": %u, "
+                     "\"meanAbs\": %.4f, \"max\": %.0f, \"psnr\": %.2f, \"over2\": %.6f }",
+                     letterCodeName(results[0].letterCode), letterModeName(results[0].letters),
+                     backgroundModeName(results[0].background), antialiasModeName(results[0].antialias),
+                     shaderPrecisionName(results[0].precision), BENCH_ERROR_SAMPLES, result.error.meanAbs,
+                     result.error.max, result.error.psnr, result.error.over2);
+            out << "," << std::endl << "      " << line;
+        }
+        out << std::endl << "    }" << ((i + 1 < results.size()) ? "," : "") << std::endl;
+    }
+    out << "  ]" << std::endl;
+    out << "}" << std::endl;
+}
+
+// Per-frame work outside the main draw; tiles is null without letter culling. The background layer
+// is only drawn for programs that sample it. counting draws with the edge program's discarding twin,
+// and a samplesQuery counts the main draw's pixels alone
+struct FramePasses {
+    const LetterTable* message;
+    const Timeline* timeline;
+    AnimationBlock* animation;
+    LetterTiles* tiles;
+    BackgroundLayer* background;
+    float uRandom;                          // As in the Animation block
+};
+
+void drawFrame(const BenchProgram& program, const BenchResolution& resolution, const FramePasses& passes, float time,
+               bool counting = false, GLuint samplesQuery = 0) {
+    FrameAnimation animation;
+    animateFrame(*passes.timeline, *passes.message, time, animation);
+    passes.animation->setFrame(animation, time, resolution.width, resolution.height);
+    passes.animation->upload();
+    if (passes.tiles) {
+        passes.tiles->update(*passes.message, animation, resolution.width, resolution.height);
+    }
+    if (passes.background && (program.background == BACKGROUND_LAYER)) {
+        passes.background->render(resolution.width, resolution.height, time, passes.uRandom);
+    }
+    (counting ? program.countProgram : program.program)->use();
+    glClear(GL_COLOR_BUFFER_BIT);
+    if (samplesQuery) {
+        glBeginQuery(GL_SAMPLES_PASSED, samplesQuery);
+    }
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    if (samplesQuery) {
+        glEndQuery(GL_SAMPLES_PASSED);
+    }
+}
+
+// Warm up, then time every frame of the range with the program and target already bound
+void timeFrames(const BenchOptions& options, const BenchProgram& program, const FramePasses& passes, const GLuint* queries,
+                uint32_t frameCount, BenchResult& result) {
+    // Warm up shader caches and clocks on the first frame of the range
+    for (uint32_t frame = 0; frame < BENCH_WARMUP_FRAMES; frame++) {
+        drawFrame(program, result.resolution, passes, options.startTime);
+    }
+    glFinish();
+
+    result.times.cpu.reserve(frameCount);
+    result.times.gpu.reserve(frameCount);
+
+    // A query is only read back BENCH_QUERY_COUNT frames later, so the GPU never drains between frames
+    auto collectQuery = [&](uint32_t frame) {
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(queries[frame % BENCH_QUERY_COUNT], GL_QUERY_RESULT, &elapsed);
+        result.times.gpu.push_back(elapsed / 1.0e6);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    auto frameStart = start;
+    for (uint32_t frame = 0; frame < frameCount; frame++) {
+        if (frame >= BENCH_QUERY_COUNT) {
+            collectQuery(frame - BENCH_QUERY_COUNT);
+        }
+
+        glBeginQuery(GL_TIME_ELAPSED, queries[frame % BENCH_QUERY_COUNT]);
+        drawFrame(program, result.resolution, passes, options.startTime + static_cast<float>(frame) / options.fps);
+        glEndQuery(GL_TIME_ELAPSED);
+        glFlush();
+
+        auto frameEnd = std::chrono::steady_clock::now();
+        result.times.cpu.push_back(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+        frameStart = frameEnd;
+    }
+    for (uint32_t frame = (frameCount > BENCH_QUERY_COUNT) ? frameCount - BENCH_QUERY_COUNT : 0; frame < frameCount; frame++) {
+        collectQuery(frame);
+    }
+    glFinish();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+} // timeFrames
+
+// BENCH_ERROR_SAMPLES frames spread over the time range, read back one after another as RGBA
+std::vector<uint8_t> readSamples(const BenchOptions& options, const BenchProgram& program, const BenchResolution& resolution,
+                                 const FramePasses& passes) {
+    size_t frameBytes = size_t(resolution.width) * resolution.height * 4;
+    std::vector<uint8_t> pixels(frameBytes * BENCH_ERROR_SAMPLES);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    for (uint32_t sample = 0; sample < BENCH_ERROR_SAMPLES; sample++) {
+        float time = options.startTime + (options.endTime - options.startTime) * (sample + 0.5f) / BENCH_ERROR_SAMPLES;
+        drawFrame(program, resolution, passes, time);
+        glReadPixels(0, 0, resolution.width, resolution.height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[sample * frameBytes]);
+    }
+    return pixels;
+}
+
+// Fraction of pixels an edge program supersamples over the same frames readSamples() draws, counted by
+// its discarding twin with an occlusion query
+double edgeFraction(const BenchOptions& options, const BenchProgram& program, const BenchResolution& resolution,
+                    const FramePasses& passes) {
+    GLuint query;
+    glGenQueries(1, &query);
+    uint64_t passed = 0;
+    for (uint32_t sample = 0; sample < BENCH_ERROR_SAMPLES; sample++) {
+        float time = options.startTime + (options.endTime - options.startTime) * (sample + 0.5f) / BENCH_ERROR_SAMPLES;
+        drawFrame(program, resolution, passes, time, true, query);
+        GLuint64 samples = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &samples);
+        passed += samples;
+    }
+    glDeleteQueries(1, &query);
+    return double(passed) / (double(resolution.width) * resolution.height * BENCH_ERROR_SAMPLES);
+}
+
+FrameError compareFrames(const std::vector<uint8_t>& reference, const std::vector<uint8_t>& frames) {
+    uint64_t sum = 0;
+    uint64_t squares = 0;
+    uint64_t pixelsOver = 0;
+    int largest = 0;
+    for (size_t i = 0; i < reference.size(); i += 4) {
+        int pixelLargest = 0;
+        for (size_t c = 0; c < 3; c++) {
+            int difference = std::abs(int(reference[i + c]) - int(frames[i + c]));
+            sum += difference;
+            squares += difference * difference;
+            pixelLargest = std::max(pixelLargest, difference);
+        }
+        largest = std::max(largest, pixelLargest);
+        pixelsOver += (pixelLargest > 2);
+    }
+    double pixels = reference.size() / 4.0;
+    double meanSquare = squares / (pixels * 3.0);
+    FrameError error;
+    error.meanAbs = sum / (pixels * 3.0);
+    error.max = largest;
+    error.psnr = (meanSquare > 0.0) ? 10.0 * std::log10(255.0 * 255.0 / meanSquare) : 99.0;
+    error.over2 = pixelsOver / pixels;
+    return error;
+}
+
+} // namespace
+
+bool parseResolutionList(const char* text, std::vector<BenchResolution>& resolutions) {
+    std::vector<BenchResolution> parsed;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        unsigned w = 0, h = 0;
+        if ((sscanf(item.c_str(), "%ux%u", &w, &h) != 2) || (w == 0) || (h == 0)) {
+            return false;
+        }
+        parsed.push_back({ w, h });
+    }
+    if (parsed.empty()) {
+        return false;
+    }
+    resolutions = parsed;
+    return true;
+}
+
+int runBenchMode(const BenchOptions& options) {
+    // A GL context from EGL, or from a window that is never shown; either way frames go to an FBO
+    HeadlessContext headlessContext;
+    GLFWwindow* hiddenWindow = nullptr;
+    if (options.headless) {
+        std::string error;
+        if (!headlessContext.create(error)) {
+            std::cerr << "Failed to create headless OpenGL context: " << error << std::endl;
+            return -1;
+        }
+    } else {
+        if (!glfwInit()) {
+            std::cerr << "Failed to initialize GLFW" << std::endl;
+            return -1;
+        }
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        hiddenWindow = glfwCreateWindow(64, 64, "Birthday Shader bench", nullptr, nullptr);
+        if (!hiddenWindow) {
+            std::cerr << "Failed to create GLFW window (try --headless)" << std::endl;
+            glfwTerminate();
+            return -1;
+        }
+        glfwMakeContextCurrent(hiddenWindow);
+    }
+    if (!initGLEW()) {
+        std::cerr << "Failed to initialize GLEW" << std::endl;
+        return -1;
+    }
+    std::string renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+
+    // Compile the fragment shader once per combination of letter code, letter mode, background mode, anti-aliasing
+    // and precision
+    std::string fragmentShaderStr = loadShaderSource(options.shaderPath);
+    std::string error;
+    GLuint vertexShader = buildShader(GL_VERTEX_SHADER, vertexShaderSource, error);
+    if (!vertexShader) {
+        std::cerr << "bench: " << error << std::endl;
+        return -1;
+    }
+    std::string tileDefines = letterTileDefines(options.letterCulling);
+    std::vector<BenchProgram> programs;
+    LetterAtlas atlas;
+    BackgroundLayer background;
+    for (LetterCode code : options.letterCodes) {
+        std::string tableDefines = letterTableDefines(options.message, code);
+        for (LetterMode letters : options.letterModes) {
+            for (BackgroundMode backgroundMode : options.backgroundModes) {
+                for (AntialiasMode antialias : options.antialiasModes) {
+                    for (ShaderPrecision precision : options.precisions) {
+                        BenchProgram program;
+                        program.letterCode = code;
+                        program.letters = letters;
+                        program.background = backgroundMode;
+                        program.antialias = antialias;
+                        program.precision = precision;
+                        std::string defines = tableDefines + letterShaderDefines(letters) + tileDefines +
+                            backgroundShaderDefines(backgroundMode) + precisionShaderDefines(precision);
+                        std::string source = insertDefines(fragmentShaderStr,
+                                                           defines + antialiasShaderDefines(antialias));
+                        program.program.reset(new ShaderProgram());
+                        program.program->reset(loadOrBuildProgram(vertexShaderSource, vertexShader, source,
+                                                                  program.fragmentShader, std::cerr, error));
+                        if (!program.program->id()) {
+                            std::cerr << "bench: " << error << std::endl;
+                            return -1;
+                        }
+                        program.countShader = 0;
+                        if (antialias == ANTIALIAS_EDGE) {
+                            source = insertDefines(fragmentShaderStr, defines + antialiasCountDefines());
+                            program.countProgram.reset(new ShaderProgram());
+                            program.countProgram->reset(loadOrBuildProgram(vertexShaderSource, vertexShader, source,
+                                                                           program.countShader, std::cerr, error));
+                            if (!program.countProgram->id()) {
+                                std::cerr << "bench: " << error << std::endl;
+                                return -1;
+                            }
+                        }
+                        for (ShaderProgram* built : { program.program.get(), program.countProgram.get() }) {
+                            if (built && built->id()) {
+                                built->use();
+                                setLetterUniforms(*built, options.message);
+                                AnimationBlock::bindBlock(*built);
+                                LetterAtlas::bindSampler(*built);
+                                LetterTiles::bindSampler(*built);
+                                BackgroundLayer::bindSampler(*built);
+                            }
+                        }
+                        programs.push_back(std::move(program));
+                    }
+                }
+            }
+        }
+    }
+    if (std::find(options.letterModes.begin(), options.letterModes.end(), LETTERS_ATLAS) != options.letterModes.end()) {
+        atlas.create();
+        std::cerr << "bench: letter atlas baked in " << atlas.bakeMilliseconds() << " ms" << std::endl;
+    }
+    if (std::find(options.backgroundModes.begin(), options.backgroundModes.end(), BACKGROUND_LAYER) !=
+        options.backgroundModes.end()) {
+        if (!background.create(fragmentShaderStr, vertexShader, options.backgroundScale, std::cerr, error)) {
+            std::cerr << "bench: background pass failed to build: " << error << std::endl;
+            return -1;
+        }
+    }
+    bool compareWithFirst = (programs.size() > 1);
+    LetterTiles tiles;
+    if (options.letterCulling) {
+        tiles.create();
+    }
+    AnimationBlock animationBlock;
+    animationBlock.create();
+    FramePasses passes;
+    passes.message = &options.message;
+    passes.timeline = &options.timeline;
+    passes.animation = &animationBlock;
+    passes.tiles = options.letterCulling ? &tiles : nullptr;
+    passes.background = &background;
+    passes.uRandom = options.uRandom;
+    animationBlock.setRandom(options.uRandom);
+
+    GLuint VBO, VAO;
+    createFullscreenQuad(VAO, VBO);
+
+    GLuint queries[BENCH_QUERY_COUNT];
+    glGenQueries(BENCH_QUERY_COUNT, queries);
+
+    uint32_t frameCount = static_cast<uint32_t>(std::max(1.0, std::ceil(double(options.endTime - options.startTime) * options.fps)));
+    std::vector<BenchResult> results;
+
+    for (const BenchResolution& resolution : options.resolutions) {
+        OffscreenTarget target;
+        if (!target.create(resolution.width, resolution.height)) {
+            std::cerr << "Failed to create " << resolution.width << "x" << resolution.height << " framebuffer" << std::endl;
+            return -1;
+        }
+        target.bind();
+
+        std::vector<uint8_t> reference;
+        for (const BenchProgram& program : programs) {
+            BenchResult result;
+            result.resolution = resolution;
+            result.letterCode = program.letterCode;
+            result.letters = program.letters;
+            result.background = program.background;
+            result.antialias = program.antialias;
+            result.precision = program.precision;
+            result.compared = false;
+            timeFrames(options, program, passes, queries, frameCount, result);
+            result.edgeFraction = program.countProgram ? edgeFraction(options, program, resolution, passes) : -1.0;
+
+            // The first program is the reference the others are measured against
+            if (compareWithFirst) {
+                std::vector<uint8_t> samples = readSamples(options, program, resolution, passes);
+                if (reference.empty()) {
+                    reference.swap(samples);
+                } else {
+                    result.error = compareFrames(reference, samples);
+                    result.compared = true;
+                }
+            }
+
+            std::cerr << "bench " << resolution.width << "x" << resolution.height << " " << letterCodeName(program.letterCode)
+                      << "/" << letterModeName(program.letters) << "/" << backgroundModeName(program.background) << "/"
+                      << antialiasModeName(program.antialias) << "/" << shaderPrecisionName(program.precision) << ": "
+                      << frameCount << " frames in " << result.seconds << " s";
+            if (result.edgeFraction >= 0.0) {
+                std::cerr << ", " << result.edgeFraction * 100.0 << "% of pixels supersampled";
+            }
+            std::cerr << std::endl;
+            results.push_back(result);
+        }
+    }
+
+    glDeleteQueries(BENCH_QUERY_COUNT, queries);
+    glDeleteBuffers(1, &VBO);
+    glDeleteVertexArrays(1, &VAO);
+    for (const BenchProgram& program : programs) {
+        glDeleteShader(program.fragmentShader);
+        glDeleteShader(program.countShader);
+    }
+    programs.clear();
+    glDeleteShader(vertexShader);
+    animationBlock.destroy();
+    atlas.destroy();
+    tiles.destroy();
+    background.destroy();
+    if (hiddenWindow) {
+        glfwTerminate();
+    }
+
+    if (options.outputPath.empty()) {
+        writeReport(std::cout, options, renderer, results);
+    } else {
+        std::ofstream file(options.outputPath);
+        writeReport(file, options, renderer, results);
+        if (!file) {
+            std::cerr << "Failed to write report: " << options.outputPath << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+} // runBenchMode
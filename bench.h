@@ -0,0 +1,66 @@
+/*******************************************************************
+    Birthday Shader 2025 - deterministic benchmark
+
+    Renders the animation offscreen at a list of resolutions with a
+    fixed iTime step and a seeded uRandom, so two runs (or two builds)
+    draw exactly the same frames. Per-frame CPU time and GPU time from
+    GL_TIME_ELAPSED queries are summarised as JSON. With both letter
+    codes, letter modes and/or background modes, or all anti-aliasing
+    modes or precision tiers, every resolution is timed once per
+    combination, and each combination's frames are compared pixel by
+    pixel with those of the first: the mean and largest difference of
+    any channel, at the same iTime and uRandom.
+*******************************************************************/
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "animation.h"
+#include "antialias.h"
+#include "background_layer.h"
+#include "letter_atlas.h"
+#include "letter_shader.h"
+#include "letter_tiles.h"
+#include "precision.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+constexpr uint32_t BENCH_WARMUP_FRAMES = 30;   // Rendered before measuring each resolution
+constexpr uint32_t BENCH_QUERY_COUNT = 4;      // Timer queries in flight before the CPU waits on one
+constexpr uint32_t BENCH_DEFAULT_SEED = 2025;
+constexpr uint32_t BENCH_ERROR_SAMPLES = 8;    // Frames across the time range read back for the comparison
+
+struct BenchResolution {
+    uint32_t width;
+    uint32_t height;
+};
+
+struct BenchOptions {
+    std::vector<BenchResolution> resolutions;
+    bool headless;                          // EGL context instead of a hidden GLFW window
+    float startTime;                        // Frames are rendered for iTime in [startTime, endTime)
+    float endTime;
+    float fps;                              // Fixed iTime step is 1 / fps
+    uint32_t seed;                          // Only recorded in the report; uRandom is derived from it by the caller
+    float uRandom;
+    std::string outputPath;                 // JSON report, stdout if empty
+    std::string shaderPath;                 // Built-in shader if empty
+    LetterTable message;
+    Timeline timeline;
+    std::vector<LetterCode> letterCodes;    // Timed in this order, each with every letter and background mode
+    std::vector<LetterMode> letterModes;
+    bool letterCulling;
+    std::vector<BackgroundMode> backgroundModes;
+    std::vector<AntialiasMode> antialiasModes;
+    std::vector<ShaderPrecision> precisions;      // The first combination is the error reference
+    float backgroundScale;
+};
+
+// Parse "1280x720,1920x1080,..."
+bool parseResolutionList(const char* text, std::vector<BenchResolution>& resolutions);
+
+// --bench: time every frame at every resolution and write the JSON report
+int runBenchMode(const BenchOptions& options);
+
+#endif // BENCH_H
@@ -1,190 +1,164 @@
 #version 330 core
 out vec4 O;
 in vec2 fragCoord;
-uniform vec2 iResolution;
-uniform float iTime;
-uniform float uScale;
-uniform float uRandom;
+
+// Everything that is the same for every pixel of a frame: the time, size and seed, and what the host
+// evaluates once per frame from the timeline and the letter table (animation.cpp). Uploaded in one
+// block, and only when something in it changed (animation_block.cpp)
+#define LETTER_MAX 16
+layout(std140) uniform Animation {
+    vec4 uLetterOffset[LETTER_MAX];     // .xy: letter N is drawn in the frame st = uv + offset
+    mat2 uWobble;                       // rot(sin(iTime * 4.) * .1), what every letter function turns by
+    float uScale;
+    float iTime;
+    vec2 iResolution;
+    float uRandom;
+};
 
 #define PI 3.1415926535
 //NOTE The SAT() macro from the original shadertoy this was based off (see below) had the
 //  parameters for clamp REVERSED (0.0, 1.0, x) which is.. non-sensical but somehow still
 //  worked on Apple and Intel silicon but not with nVidia
 #define C(x) clamp(x, 0.0, 1.0)
-#define S(a, b, x) smoothstep(a, b, x)
-
-#define SETUP_LETTER(LX, LY, LA, LS, LXINC, LYINC) { \
-    st = vec2(LX, LY); \
-    angle = LA; \
-    spiral = LS; \
-    st.x += LXINC; \
-    st.y += LYINC; \
+#define S(a, b, x) H(smoothstep(a, b, x))
+
+// Precision tiers (--precision, precision.cpp). MP marks what the hot paths hold that half a float's
+// precision is enough for: sdBox(), rot(), noise()'s interpolation and the smoothstep compositing. It is
+// mediump under PRECISION_MEDIUM, which GPUs with 16-bit ALUs honour and desktop GL accepts and ignores.
+// PRECISION_HALF rounds each of those values with H() to the 11 significant bits of a half float as well,
+// so the error the medium tier would show on such a GPU shows here too. hash() stays highp:
+// fract(sin(p)*43758.5453) keeps exactly the digits a half float drops
+#if defined(PRECISION_MEDIUM) || defined(PRECISION_HALF)
+#define MP mediump
+#else
+#define MP
+#endif
+#ifdef PRECISION_HALF
+float H(float x) { return uintBitsToFloat((floatBitsToUint(x) + 0x1000u) & 0xFFFFE000u); }
+vec2 H(vec2 x) { return vec2(H(x.x), H(x.y)); }
+vec3 H(vec3 x) { return vec3(H(x.x), H(x.y), H(x.z)); }
+mat2 H(mat2 m) { return mat2(H(m[0]), H(m[1])); }
+#else
+#define H(x) (x)
+#endif
+
+#define SETUP_LETTER(N) { \
+    st = uv + uLetterOffset[N].xy; \
     topGrad = 1.3 - S(0.0, 1.0, C(pow(3.0 * st.y - uv.y,2))); \
     botGrad = 0.7 + S(0.0, 1.0, C(pow(3.0 * st.y - uv.y,2))); }
 
 
-mat2 rot(float a) {
-    return mat2(cos(a), -sin(a), sin(a), cos(a));
-}
-
-
-/***************************** Background functions *****************************/
-
-// Based on code from https://www.shadertoy.com/view/wdyczG
-
-vec2 hash(vec2 p) {
-    p = vec2( dot(p,vec2(2127.1,81.17)), dot(p,vec2(1269.5,283.37)) );
-	return fract(sin(p)*43758.5453);
-}
-
-float noise(vec2 p) {
-    vec2 i = floor(p);
-    vec2 f = fract(p);
-	vec2 u = f*f*(3.0-2.0*f);
-    float n = mix( mix( dot( -1.0+2.0*hash( i + vec2(0.0,0.0) ), f - vec2(0.0,0.0) ), 
-                        dot( -1.0+2.0*hash( i + vec2(1.0,0.0) ), f - vec2(1.0,0.0) ), u.x),
-                   mix( dot( -1.0+2.0*hash( i + vec2(0.0,1.0) ), f - vec2(0.0,1.0) ), 
-                        dot( -1.0+2.0*hash( i + vec2(1.0,1.0) ), f - vec2(1.0,1.0) ), u.x), u.y);
-	return 0.5 + 0.5*n;
-}
-
-vec3 drawBackground() {
-    vec2 uv = (fragCoord/iResolution.xy) - 0.5;
-    float ratio = iResolution.x / iResolution.y;
-
-    // rotate with Noise (and use provided random seed and a 'special number')
-    float degree = noise(vec2((iTime + (uRandom * 2002.411)) * 0.08, uv.x*uv.y));
-
-    uv.y *= 1./ratio;
-    uv *= rot(radians((degree-.5)*720.+180.));
-	uv.y *= ratio;
-
-    // Wave warp with sin
-    float frequency = 5.;
-    float amplitude = 30.;
-    float speed = iTime * 2.;
-    uv.x += sin(uv.y*frequency+speed)/amplitude;
-   	uv.y += sin(uv.x*frequency*1.5+speed)/(amplitude*.5);
-    
-    // draw the image
-    vec3 colorYellow = vec3(.957, .804, .623);
-    vec3 colorDeepBlue = vec3(.192, .384, .933);
-    vec3 layer1 = mix(colorYellow, colorDeepBlue, S(-.3, .2, (uv*rot(radians(-5.))).x));
-    
-    vec3 colorRed = vec3(.910, .510, .8);
-    vec3 colorBlue = vec3(0.350, .71, .953);
-    vec3 layer2 = mix(colorRed, colorBlue, S(-.3, .2, (uv*rot(radians(-5.))).x));
-    
-    return mix(layer1, layer2, S(.5, -.3, uv.y));
-} // drawBackground
-
-
-/***************************** 'Letterbox' ;-) functions *****************************/
-
-// Based on code from https://www.shadertoy.com/view/3sByD1
-
-float sdBox(vec2 p, vec2 b)
-{
-    vec2 d = abs(p) - b;
-    return length(max(d, 0.)) + min(max(d.x, d.y), 0.);
-}
-
-float sdA(vec2 uv, float ah, float al, float t, bool inner)
-{
-    uv *= rot(sin((iTime) * 4.) * .1);
- 	float a = 0.;
-    a = S(ah, al, sdBox(vec2(uv.x + .1, uv.y) * rot(PI * .08), vec2(t, .25 + t)));
-    a += S(ah, al, sdBox(vec2(uv.x - .1, uv.y) * rot(-PI * .08), vec2(t, .25 + t)));
-    a += S(ah, al, sdBox(vec2(uv.x, uv.y + .05), vec2(.1, t * .8)));
-    a = min(a, S(ah, al, sdBox(uv, vec2(.26, .26))));
-    if(inner)
-    	a = min(a, S(ah, al, sdBox(uv, vec2(.26, .25))));
-    return a;
-}
-
-float sdB(vec2 uv, float ah, float al, float t, float inner)
-{
-	uv *= rot(sin((iTime) * 4.) * .1);
-    float b = S(ah, al, sdBox(vec2(uv.x + .12, uv.y), vec2(t, .2 + t)));
-    b += S(ah, al, abs(sdBox(vec2(uv.x+t+inner, uv.y-.12), vec2(.1, .0001))-.09)-t*.9);
-    b += S(ah, al, abs(sdBox(vec2(uv.x+t+inner, uv.y+.12), vec2(.1, .0001))-.09)-t*.9);
-    b = min(b, S(ah, al, sdBox(vec2(uv.x - .04, uv.y), vec2(.22, .28))));
-    if (inner > 0.)
-        b = min(b, S(ah, al, sdBox(vec2(uv.x - .0435, uv.y), vec2(.21, .28))));
-    return b; 
-}
-
-float sdD(vec2 uv, float ah, float al, float t, float inner)
-{
-    uv *= rot(sin(iTime * 4.) * .1);
-	float d = S(ah, al, sdBox(vec2(uv.x + .12, uv.y), vec2(t, .2 + t)));
-    d += S(ah, al, abs(sdBox(vec2(uv.x+t+inner+.06, uv.y), vec2(.1, .0001))-.202)-t);
-    d = min(d, S(ah, al, sdBox(vec2(uv.x - .04, uv.y), vec2(.22, .28))));
-    if (inner > 0.)
-        d = min(d, S(ah, al, sdBox(vec2(uv.x - .07, uv.y), vec2(.236, .26))));
-    return d;
-}
-
-float sdH(vec2 uv, float ah, float al, float t)
-{
-    uv *= rot(sin(iTime * 4.) * .1);
-	float h = 0.;
-    h = S(ah, al, sdBox(vec2(uv.x + .12, uv.y), vec2(t, .2 + t)));
-    h += S(ah, al, sdBox(vec2(uv.x - .12, uv.y), vec2(t, .2 + t)));
-    h += S(ah, al, sdBox(uv, vec2(.1, t)));
-    return h;
+MP mat2 rot(MP float a) {
+    a = H(a);
+    return H(mat2(cos(a), -sin(a), sin(a), cos(a)));
 }
 
-float sdI(vec2 uv, float ah, float al, float t)
-{
-    uv *= rot(sin(iTime * 4.) * .1);
-    return S(ah, al, sdBox(uv, vec2(t, .2 + t)));
-}
 
-float sdP(vec2 uv, float ah, float al, float t, float inner)
+#include "background.glsl"
+
+
+#include "letters.glsl"
+
+/***************************** Letter tiles *****************************/
+
+// With LETTER_TILES defined the host bins the letters into LETTER_TILE_SIZE pixel tiles every frame
+// (letter_tiles.cpp) and each tile's bitmask says which of the letters can touch it
+#ifdef LETTER_TILES
+#define LETTER_TILE_SIZE 32
+uniform usampler2D uLetterTiles;
+#define LETTER_IN_TILE(N) ((letterMask & (1u << N)) != 0u)
+#else
+#define LETTER_IN_TILE(N) true
+#endif
+
+// --profile leaves sections out to time what each costs (profile.cpp): ABLATE_LETTERS is a mask of
+// the letters not drawn, ABLATE_BACKGROUND puts a flat colour in place of the background, and
+// ABLATE_SHADOW, ABLATE_OUTLINE and ABLATE_FILL drop that layer of every letter (letters.glsl)
+#ifdef ABLATE_LETTERS
+#define LETTER_VISIBLE(N) (((ABLATE_LETTERS & (1u << N)) == 0u) && LETTER_IN_TILE(N))
+#else
+#define LETTER_VISIBLE(N) LETTER_IN_TILE(N)
+#endif
+
+/***************************** Letter table *****************************/
+
+// The message comes from a letter table (birthday.letters) that the host turns into code
+// (letter_shader.cpp): either a generated LETTER_BLOCKS #define, one block per letter with its
+// glyph and colour written in, or LETTER_UNIFORMS, where drawLetters() loops over the table held
+// in the uniform arrays below. Where the letters are comes from the Animation block either way.
+// Each glyph is drawn the same way wherever it appears
+#define DRAW_GLYPH_A(FILL_COLOR) DRAW_LETTER(GLYPH_A, FILL_COLOR, C(sdA(st, .05, -.05, .05, false)), \
+    sdA(st, .015, .005, .055, false), sdA(st, .015, .005, .044, true))
+#define DRAW_GLYPH_B(FILL_COLOR) DRAW_LETTER(GLYPH_B, FILL_COLOR, sdB(st, .06, -.06, .05, 0.), \
+    sdB(st, .015, .005, .06, 0.), sdB(st, .015, .005, .046, .01))
+#define DRAW_GLYPH_D(FILL_COLOR) DRAW_LETTER(GLYPH_D, FILL_COLOR, sdD(st, .06, -.06, .05, 0.), \
+    sdD(st, .015, .005, .06, 0.), sdD(st, .015, .005, .046, .01))
+#define DRAW_GLYPH_H(FILL_COLOR) DRAW_LETTER(GLYPH_H, FILL_COLOR, sdH(st, .06, -.05, .06), \
+    sdH(st, .015, .005, .06), C(sdH(st, .015, .005, .048)))
+#define DRAW_GLYPH_I(FILL_COLOR) DRAW_LETTER(GLYPH_I, FILL_COLOR, sdI(st, .06, -.06, .06), \
+    sdI(st, .015, .005, .06), sdI(st, .015, .005, .048))
+#define DRAW_GLYPH_P(FILL_COLOR) DRAW_LETTER(GLYPH_P, FILL_COLOR, sdP(st, .06, -.06, .05, 0.), \
+    sdP(st, .015, .005, .06, 0.), sdP(st, .015, .005, .046, .01))
+#define DRAW_GLYPH_R(FILL_COLOR) DRAW_LETTER(GLYPH_R, FILL_COLOR, sdR(st, .06, -.06, .05, .0), \
+    sdR(st, .015, .005, .06, .0), sdR(st, .015, .005, .046, .01))
+#define DRAW_GLYPH_T(FILL_COLOR) DRAW_LETTER(GLYPH_T, FILL_COLOR, sdT(st, .06, -.06, .06, false), \
+    sdT(st, .015, .005, .06, false), C(sdT(st, .015, .005, .048, true)))
+#define DRAW_GLYPH_Y(FILL_COLOR) DRAW_LETTER(GLYPH_Y, FILL_COLOR, sdY(st, .05, -.05, .05, false), \
+    sdY(st, .015, .005, .06, false), sdY(st, .015, .005, .048, true))
+
+#ifdef LETTER_UNIFORMS
+uniform int uLetterCount;
+uniform vec4 uLetterColor[LETTER_MAX];          // Fill colour, .a is 1. in the bottom row
+uniform int uLetterGlyph[LETTER_MAX];
+#elif !defined(LETTER_BLOCKS)
+#error The host generates LETTER_BLOCKS from the letter table, or defines LETTER_UNIFORMS
+#endif
+
+/***************************** Letters *****************************/
+
+// The letters drawn over the background colour col at uv. Without LETTER_TILES letterMask is unused
+vec3 drawLetters(MP vec3 col, vec2 uv, uint letterMask)
 {
-    uv *= rot(sin(iTime * 4.) * .1);
-    float p = S(ah, al, sdBox(vec2(uv.x + .12, uv.y), vec2(t, .2 + t)));
-    p += S(ah, al, abs(sdBox(vec2(uv.x+t+inner, uv.y-.106), vec2(.1, .0001))-.1)-t);
-    p = min(p, S(ah, al, sdBox(vec2(uv.x - .04, uv.y), vec2(.22, .28))));
-    if (inner > 0.)
-        p = min(p, S(ah, al, sdBox(vec2(uv.x - .043, uv.y), vec2(.21, .28))));
-    return p;
-}
+    const vec3 white = vec3(1.0);
+    const vec3 shadow = vec3(0.1);
+    float shadowStr = .666;
+    float topGrad = 0.0;
+    float botGrad = 0.0;
+    vec2 st = vec2(0);
 
-float sdR(vec2 uv, float ah, float al, float t, float inner)
-{
-    uv *= rot(sin(iTime * 4.) * .1);
-    float r = S(ah, al, sdBox(vec2(uv.x + .12, uv.y), vec2(t, .2 + t)));
-    r += S(ah, al, abs(sdBox(vec2(uv.x+t+inner, uv.y-.106), vec2(.1, .0001))-.1)-t);
-    r += S(ah, al, sdBox(vec2(uv.x - .1, uv.y + .18) * rot(-PI * .2), vec2(t, .2)));
-    r = min(r, S(ah, al, sdBox(vec2(uv.x - .04, uv.y - .02), vec2(.22, .28))));
-    if (inner > 0.)
-        r = min(r, S(ah, al, sdBox(vec2(uv.x-.04, uv.y-.02-inner), vec2(.207, .28))));
-    return r;
+#ifdef LETTER_UNIFORMS
+    for (int i = 0; i < uLetterCount; i++) {
+        if (LETTER_VISIBLE(i)) {
+            SETUP_LETTER(i);
+            vec3 fill = mix(white, uLetterColor[i].rgb, (uLetterColor[i].a > .5) ? botGrad : topGrad);
+            switch (uLetterGlyph[i]) {
+            case GLYPH_A: DRAW_GLYPH_A(fill); break;
+            case GLYPH_B: DRAW_GLYPH_B(fill); break;
+            case GLYPH_D: DRAW_GLYPH_D(fill); break;
+            case GLYPH_H: DRAW_GLYPH_H(fill); break;
+            case GLYPH_I: DRAW_GLYPH_I(fill); break;
+            case GLYPH_P: DRAW_GLYPH_P(fill); break;
+            case GLYPH_R: DRAW_GLYPH_R(fill); break;
+            case GLYPH_T: DRAW_GLYPH_T(fill); break;
+            case GLYPH_Y: DRAW_GLYPH_Y(fill); break;
+            }
+        }
+    }
+#else
+    LETTER_BLOCKS
+#endif
+    return col;
 }
 
-float sdT(vec2 uv, float ah, float al, float t, bool inner)
-{
-    uv *= rot(sin(iTime * 4.) * .1);
-	float tt = S(ah, al, sdBox(vec2(uv.x, uv.y + .03), vec2(t, .23)));
-    tt += S(ah, al, sdBox(vec2(uv.x, uv.y - .2), vec2(.23, t)));
-    if(inner)
-        tt = min(tt, S(ah, al, sdBox(uv, vec2(.22, .25))));
-    return tt;
-}
+/***************************** Anti-aliasing *****************************/
 
-float sdY(vec2 uv, float ah, float al, float t, bool inner)
-{
-    uv *= rot(sin(iTime * 4.) * .1);
-    float y = S(ah, al, sdBox(vec2(uv.x, uv.y + .14), vec2(t, .12)));
-    y += S(ah, al, sdBox(vec2(uv.x + .1, uv.y - .14) * rot(PI * .86), vec2(t, .24)));
-    y += S(ah, al, sdBox(vec2(uv.x - .1, uv.y - .14) * rot(-PI * .86), vec2(t, .24)));
-    y = min(y, S(ah, al, sdBox(vec2(uv.x, uv.y + .2), vec2(.45))));
-    if (inner)
-        y = min(y, S(ah, al, sdBox(vec2(uv.x, uv.y + .005), vec2(.3, .245))));
-    return y;
-}
+// The outlines are only a few hundredths of uv wide, less than a pixel when zoomed out. AA_FULL
+// takes four more samples of the letters at every pixel; AA_EDGE only where they change colour from
+// one pixel to the next (fwidth over the 2x2 quad), so the background and the letter interiors stay
+// at one sample. The background is smooth and sampled once either way. AA_EDGE_COUNT discards every
+// other pixel, for the host to count edge pixels with an occlusion query
+#define AA_EDGE_THRESHOLD .1
+const vec2 aaOffsets[4] = vec2[4](vec2(-.125, -.375), vec2(.375, -.125), vec2(.125, .375), vec2(-.375, .125));
 
 /***************************** Main function *****************************/
 
@@ -193,107 +167,47 @@ void main()
     // Fix coordinates for aspect ratio and scale
     vec2 uv = (fragCoord + fragCoord - iResolution.xy) / iResolution.y * uScale;
     
-    vec3 col = drawBackground();
-
-    const vec3 white = vec3(1.0);
-    const vec3 shadow = vec3(0.1);
-    float shadowStr = .666;
-    float topGrad = 0.0;
-    float botGrad = 0.0;
-    vec2 st = vec2(0);
-    float angle = 0.0;
-    float spiral = 0.0;
-
-// H
-    SETUP_LETTER(uv.x + .76, uv.y - .4, iTime * 2.0, exp(-1.5 * iTime), spiral * 10.0 * sin(angle), spiral * 12.5 * cos(angle));
-	col = mix(col, shadow, shadowStr * sdH(st, .06, -.05, .06));
-    col = mix(col, white, sdH(st, .015, .005, .06));
-    col = mix(col, mix(white, vec3(.006, .08, .99), topGrad), 
-              C(sdH(st, .015, .005, .048)));
-
-// A
-    SETUP_LETTER(uv.x + .37, uv.y - .4, iTime * 3.0, exp(-0.6 * iTime), spiral * cos(angle), spiral * 2.2 * cos(angle));
-    col = mix(col, shadow, shadowStr * C(sdA(st, .05, -.05, .05, false)));
-    col = mix(col, white, sdA(st, .015, .005, .055, false));
-    col = mix(col, mix(white, vec3(.99, .001, .005), topGrad), 
-              sdA(st, .015, .005, .044, true));
-
-// P
-    SETUP_LETTER(uv.x, uv.y - .4, iTime * 2.5, exp(-0.7 * iTime), spiral * -5.5 * sin(angle), spiral * 8.4 * cos(angle));
-    col = mix(col, shadow, shadowStr * sdP(st, .06, -.06, .05, 0.));
-    col = mix(col, white, sdP(st, .015, .005, .06, 0.));
-    col = mix(col, mix(white, vec3(.02, .95, .06), topGrad),
-              sdP(st, .015, .005, .046, .01));
-
-// P
-    SETUP_LETTER(uv.x - .34, uv.y - .4, iTime * 4.0, exp(-0.35 * iTime), spiral * cos(angle), spiral * sin(angle));
-    col = mix(col, shadow, shadowStr * sdP(st, .06, -.06, .05, 0.));
-    col = mix(col, white, sdP(st, .015, .005, .06, 0.));
-    col = mix(col, mix(white, vec3(.98, .42, .01), topGrad),
-              sdP(st, .015, .005, .046, .01));
-
-// Y
-    SETUP_LETTER(uv.x - .66, uv.y - .4, iTime * 3.0, exp(-2.0 * iTime), spiral * 9.0 * max(0.0, 1.0 - 0.4 * iTime), spiral * 13.0 * max(0.0, 1.0 - 0.25 * iTime));
-    col = mix(col, shadow, shadowStr * sdY(st, .05, -.05, .05, false));
-    col = mix(col, white, sdY(st, .015, .005, .06, false));
-    col = mix(col, mix(white, vec3(.98, .01, .34), topGrad), 
-              sdY(st, .015, .005, .048, true));
-
-// B
-    SETUP_LETTER(uv.x + 1.2, uv.y + .4, iTime * 3.0, exp(-2.0 * iTime), spiral * pow(iTime + 2.0, 3) * cos(angle), spiral * pow(iTime + 3.0, 2) * sin(angle));
-    col = mix(col, shadow, shadowStr * sdB(st, .06, -.06, .05, 0.));
-    col = mix(col, white, sdB(st, .015, .005, .06, 0.));
-    col = mix(col, mix(white, vec3(.99, .001, .005), botGrad),
-              sdB(st, .015, .005, .046, .01));
-
-// I
-    SETUP_LETTER(uv.x + .96, uv.y + .4, iTime * 3.0, exp(-2.0 * iTime), spiral * sin(angle), pow(spiral, 0.35) * 5.0 * sin(angle));
-    col = mix(col, shadow, shadowStr * sdI(st, .06, -.06, .06));
-    col = mix(col, white, sdI(st, .015, .005, .06));
-    col = mix(col, mix(white, vec3(.01, .56, .87), botGrad), 
-              sdI(st, .015, .005, .048));
-
-// R
-    SETUP_LETTER(uv.x + .71, uv.y + .4, iTime * 2.0, exp(-1.0 * iTime), spiral * 0.5 * cos(angle), spiral * 3.0 * sin(angle));
-    col = mix(col, shadow, shadowStr * sdR(st, .06, -.06, .05, .0));
-	col = mix(col, white, sdR(st, .015, .005, .06, .0));
-    col = mix(col, mix(white, vec3(.48, .005, .76), botGrad),
-              sdR(st, .015, .005, .046, .01));
-
-// T
-    SETUP_LETTER(uv.x + .32, uv.y + .4, iTime * 1.1, exp(-0.5 * iTime), spiral * 8.0 * sin(angle), spiral * 4.5 * cos(angle));
-    col = mix(col, shadow, shadowStr * sdT(st, .06, -.06, .06, false));
-    col = mix(col, white, sdT(st, .015, .005, .06, false));
-    col = mix(col, mix(white, vec3(.97, .96, .006), botGrad), 
-              C(sdT(st, .015, .005, .048, true)));
-
-// H
-    SETUP_LETTER(uv.x - .08, uv.y + .4, iTime * 2.4, exp(-0.9 * iTime), spiral * 1.2 * sin(angle), spiral * 2.9 * cos(angle));
-    col = mix(col, shadow, shadowStr * sdH(st, .06, -.05, .06));
-    col = mix(col, white, sdH(st, .015, .005, .06));
-    col = mix(col, mix(white, vec3(.98, .01, .34), botGrad), 
-              C(sdH(st, .015, .005, .048)));
-
-// D
-    SETUP_LETTER(uv.x - .45, uv.y + .4, iTime * 4.0, exp(-1.5 * iTime), spiral * cos(angle), spiral * sin(angle));
-    col = mix(col, shadow, shadowStr * sdD(st, .06, -.06, .05, 0.));
-    col = mix(col, white, sdD(st, .015, .005, .06, 0.));
-    col = mix(col, mix(white, vec3(.02, .95, .06), botGrad), 
-              sdD(st, .015, .005, .046, .01));
-
-// A
-    SETUP_LETTER(uv.x - .82, uv.y + .4, iTime * 1.8, exp(-0.5 * iTime), spiral * cos(angle) * sin(angle), spiral * cos(angle));
-    col = mix(col, shadow, shadowStr * sdA(st, .05, -.05, .05, false));
-    col = mix(col, white, sdA(st, .015, .005, .055, false));
-    col = mix(col, mix(white, vec3(.006, .08, .99), botGrad), 
-              sdA(st, .015, .005, .044, true));
-
-// Y
-    SETUP_LETTER(uv.x - 1.12, uv.y + .4, iTime * 7.0, exp(-3.1 * iTime), spiral * cos(angle), spiral * 8.0 * sin(angle));
-    col = mix(col, shadow, shadowStr * sdY(st, .05, -.05, .05, false));
-    col = mix(col, white, sdY(st, .015, .005, .06, false));
-    col = mix(col, mix(white, vec3(.98, .42, .01), botGrad), 
-              sdY(st, .015, .005, .048, true));
+#ifdef BACKGROUND_PASS
+    O = vec4(drawBackground(), 1.);
+    return;
+#endif
+#if defined(ABLATE_BACKGROUND)
+    vec3 background = vec3(.5);
+#elif defined(BACKGROUND_TEXTURE)
+    vec3 background = texture(uBackground, fragCoord / iResolution.xy).rgb;
+#else
+    vec3 background = drawBackground();
+#endif
+
+#ifdef LETTER_TILES
+    uint letterMask = texelFetch(uLetterTiles, ivec2(fragCoord) / LETTER_TILE_SIZE, 0).r;
+#else
+    uint letterMask = 0u;
+#endif
+    vec3 col = drawLetters(background, uv, letterMask);
+
+#if defined(AA_EDGE) || defined(AA_FULL)
+#ifdef AA_EDGE
+    vec3 change = fwidth(col - background);
+    bool edge = max(change.r, max(change.g, change.b)) > AA_EDGE_THRESHOLD;
+#else
+    bool edge = true;
+#endif
+#ifdef AA_EDGE_COUNT
+    if (!edge)
+        discard;
+#endif
+    // Rotated grid around the centre sample, in pixels turned into uv. A loop that runs no times rather
+    // than an if: llvmpipe runs both sides of a branch under a mask, but leaves a loop once no pixel
+    // of the block is still in it
+    float pixel = 2. / iResolution.y * uScale;
+    int extraSamples = edge ? 4 : 0;
+    vec3 sum = col;
+    for (int i = 0; i < extraSamples; i++) {
+        sum += drawLetters(background, uv + aaOffsets[i] * pixel, letterMask);
+    }
+    col = edge ? sum * .2 : col;
+#endif
 
     O = vec4(pow(col, vec3(.8)), 1.);
 }
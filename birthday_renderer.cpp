@@ -0,0 +1,231 @@
+/*******************************************************************
+    Birthday Shader 2025 - embeddable renderer
+*******************************************************************/
+#include "birthday_renderer.h"
+#include "gl_common.h"
+#include "scene.h"
+
+#include <ostream>
+#include <string>
+
+struct BirthdayRenderer {
+    Scene scene;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    float time = 0.0f;
+};
+
+namespace {
+
+thread_local std::string lastError;
+
+// Texture units the scene binds, and what it binds there
+struct SceneUnit {
+    GLint unit;
+    GLenum target;
+    GLenum binding;
+};
+
+const SceneUnit sceneUnits[] = {
+    { LETTER_ATLAS_TEXTURE_UNIT, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BINDING_2D_ARRAY },
+    { LETTER_TILES_TEXTURE_UNIT, GL_TEXTURE_2D, GL_TEXTURE_BINDING_2D },
+    { BACKGROUND_TEXTURE_UNIT, GL_TEXTURE_2D, GL_TEXTURE_BINDING_2D },
+    { NOISE_TEXTURE_UNIT, GL_TEXTURE_2D, GL_TEXTURE_BINDING_2D },
+};
+constexpr int SCENE_UNIT_COUNT = sizeof(sceneUnits) / sizeof(sceneUnits[0]);
+
+const GLenum hostCapabilities[] = { GL_BLEND, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_SCISSOR_TEST, GL_CULL_FACE };
+constexpr int HOST_CAPABILITY_COUNT = sizeof(hostCapabilities) / sizeof(hostCapabilities[0]);
+
+// Whatever the host had bound and enabled that the scene changes: saved and switched to what the scene
+// expects on construction, put back on destruction
+class HostState {
+public:
+    HostState() {
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+        glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+        glGetIntegerv(GL_UNIFORM_BUFFER_BINDING, &uniformBuffer);
+        glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, ANIMATION_BLOCK_BINDING, &blockBuffer);
+        glGetInteger64i_v(GL_UNIFORM_BUFFER_START, ANIMATION_BLOCK_BINDING, &blockStart);
+        glGetInteger64i_v(GL_UNIFORM_BUFFER_SIZE, ANIMATION_BLOCK_BINDING, &blockSize);
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpackBuffer);
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+        glGetIntegerv(GL_UNPACK_ROW_LENGTH, &unpackRowLength);
+        glGetBooleanv(GL_COLOR_WRITEMASK, colorMask);
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+        for (int i = 0; i < SCENE_UNIT_COUNT; i++) {
+            glActiveTexture(GL_TEXTURE0 + sceneUnits[i].unit);
+            glGetIntegerv(sceneUnits[i].binding, &textures[i]);
+            glGetIntegerv(GL_SAMPLER_BINDING, &samplers[i]);
+            glBindSampler(sceneUnits[i].unit, 0);
+        }
+        glActiveTexture(GL_TEXTURE0);
+        for (int i = 0; i < HOST_CAPABILITY_COUNT; i++) {
+            enabled[i] = glIsEnabled(hostCapabilities[i]);
+            glDisable(hostCapabilities[i]);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    }
+
+    ~HostState() {
+        for (int i = 0; i < HOST_CAPABILITY_COUNT; i++) {
+            if (enabled[i]) {
+                glEnable(hostCapabilities[i]);
+            }
+        }
+        for (int i = 0; i < SCENE_UNIT_COUNT; i++) {
+            glActiveTexture(GL_TEXTURE0 + sceneUnits[i].unit);
+            glBindTexture(sceneUnits[i].target, textures[i]);
+            glBindSampler(sceneUnits[i].unit, samplers[i]);
+        }
+        glActiveTexture(activeTexture);
+        glColorMask(colorMask[0], colorMask[1], colorMask[2], colorMask[3]);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, unpackRowLength);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, unpackBuffer);
+        if (blockSize > 0) {
+            glBindBufferRange(GL_UNIFORM_BUFFER, ANIMATION_BLOCK_BINDING, blockBuffer, blockStart, blockSize);
+        } else {
+            glBindBufferBase(GL_UNIFORM_BUFFER, ANIMATION_BLOCK_BINDING, blockBuffer);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, uniformBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
+        glBindVertexArray(vertexArray);
+        glUseProgram(program);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+    }
+
+    HostState(const HostState&) = delete;
+    HostState& operator=(const HostState&) = delete;
+
+private:
+    GLint drawFramebuffer = 0;
+    GLint readFramebuffer = 0;
+    GLint viewport[4] = {};
+    GLint program = 0;
+    GLint vertexArray = 0;
+    GLint arrayBuffer = 0;
+    GLint uniformBuffer = 0;
+    GLint blockBuffer = 0;
+    GLint64 blockStart = 0;
+    GLint64 blockSize = 0;                  // 0 when bound whole with glBindBufferBase
+    GLint unpackBuffer = 0;
+    GLint unpackAlignment = 4;
+    GLint unpackRowLength = 0;
+    GLboolean colorMask[4] = {};
+    GLint activeTexture = GL_TEXTURE0;
+    GLint textures[SCENE_UNIT_COUNT] = {};
+    GLint samplers[SCENE_UNIT_COUNT] = {};
+    GLboolean enabled[HOST_CAPABILITY_COUNT] = {};
+};
+
+// Discards the program cache's startup line; the host's stdout is its own
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+bool sceneOptions(const BirthdayConfig& config, SceneOptions& options, std::string& error) {
+    if (!loadSceneContent(config.message_path ? config.message_path : "",
+                          config.timeline_path ? config.timeline_path : "", options.message, options.timeline, error)) {
+        return false;
+    }
+    if (config.letters && !parseLetterMode(config.letters, options.letters)) {
+        error = std::string("Invalid letter mode: ") + config.letters + " (expected analytic or atlas)";
+        return false;
+    }
+    if (config.background && !parseBackgroundMode(config.background, options.background)) {
+        error = std::string("Invalid background mode: ") + config.background + " (expected inline or layer)";
+        return false;
+    }
+    if (config.antialias && !parseAntialiasMode(config.antialias, options.antialias)) {
+        error = std::string("Invalid anti-aliasing mode: ") + config.antialias + " (expected off, edge or full)";
+        return false;
+    }
+    if (config.precision && !parseShaderPrecision(config.precision, options.precision)) {
+        error = std::string("Invalid precision: ") + config.precision + " (expected high, medium or half)";
+        return false;
+    }
+    options.letterCulling = (config.letter_culling != 0);
+    return true;
+}
+
+} // namespace
+
+void birthday_default_config(BirthdayConfig* config) {
+    SceneOptions defaults;
+    *config = BirthdayConfig();
+    config->width = 800;
+    config->height = 600;
+    config->letter_culling = defaults.letterCulling ? 1 : 0;
+}
+
+BirthdayRenderer* birthday_create(const BirthdayConfig* config) {
+    SceneOptions options;
+    std::string source;
+    if (!sceneOptions(*config, options, lastError) ||
+        !loadShaderSource(config->shader_path ? config->shader_path : "", source, lastError)) {
+        return nullptr;
+    }
+    if (!initGLEW()) {
+        lastError = "Failed to initialize GLEW";
+        return nullptr;
+    }
+
+    HostState host;
+    BirthdayRenderer* renderer = new BirthdayRenderer();
+    NullBuffer discard;
+    std::ostream log(&discard);
+    if (!renderer->scene.create(options, source, log, lastError)) {
+        delete renderer;
+        return nullptr;
+    }
+    renderer->scene.setRandom(seedRandom(config->seed));
+    renderer->width = config->width;
+    renderer->height = config->height;
+    return renderer;
+}
+
+void birthday_destroy(BirthdayRenderer* renderer) {
+    if (renderer) {
+        HostState host;
+        delete renderer;
+    }
+}
+
+void birthday_resize(BirthdayRenderer* renderer, unsigned int width, unsigned int height) {
+    renderer->width = width;
+    renderer->height = height;
+}
+
+void birthday_set_time(BirthdayRenderer* renderer, double seconds) {
+    renderer->time = static_cast<float>(seconds);
+}
+
+void birthday_set_seed(BirthdayRenderer* renderer, unsigned int seed) {
+    HostState host;
+    renderer->scene.setRandom(seedRandom(seed));
+}
+
+void birthday_render_into(BirthdayRenderer* renderer, unsigned int framebuffer) {
+    if ((renderer->width == 0) || (renderer->height == 0)) {
+        return;
+    }
+    HostState host;
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, renderer->width, renderer->height);
+    renderer->scene.bind();
+    renderer->scene.render(renderer->time, renderer->width, renderer->height);
+}
+
+const char* birthday_last_error(void) {
+    return lastError.c_str();
+}
@@ -0,0 +1,62 @@
+/*******************************************************************
+    Birthday Shader 2025 - embeddable renderer
+
+    A C API over the scene (scene.h) for drawing the effect inside
+    another application's OpenGL frame: no window, no second process,
+    no copy. The caller owns the context; it has to be OpenGL 3.3 core
+    or later and current on the calling thread for every call below.
+    birthday_render_into() draws into the caller's framebuffer object
+    (0 for its window) and puts back every piece of GL state it
+    touches, so it can sit between any two draws of the host's own.
+    Link with libbirthdayshader.a, GLEW and the C++ runtime;
+    birthdayshader.c is the smallest front-end there is over it.
+*******************************************************************/
+#ifndef BIRTHDAY_RENDERER_H
+#define BIRTHDAY_RENDERER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BirthdayRenderer BirthdayRenderer;
+
+typedef struct BirthdayConfig {
+    unsigned int width;                     /* Size drawn by birthday_render_into() until birthday_resize() */
+    unsigned int height;
+    unsigned int seed;                      /* uRandom, the same number as birthdayshader --seed */
+    const char* shader_path;                /* NULL: the shader built in */
+    const char* message_path;               /* NULL: birthday.letters as built in */
+    const char* timeline_path;              /* NULL: birthday.timeline as built in */
+    const char* letters;                    /* analytic or atlas, NULL for the default */
+    const char* background;                 /* inline or layer, NULL for the default */
+    const char* antialias;                  /* off, edge or full, NULL for the default */
+    const char* precision;                  /* high, medium or half, NULL for the default */
+    int letter_culling;                     /* Non-zero skips letters per screen tile */
+} BirthdayConfig;
+
+/* The defaults birthdayshader itself runs with, at 800x600 and seed 0 */
+void birthday_default_config(BirthdayConfig* config);
+
+/* Builds the scene in the current context; NULL on failure, with birthday_last_error() saying why */
+BirthdayRenderer* birthday_create(const BirthdayConfig* config);
+
+/* Frees the scene's GL objects, so the same context has to be current */
+void birthday_destroy(BirthdayRenderer* renderer);
+
+void birthday_resize(BirthdayRenderer* renderer, unsigned int width, unsigned int height);
+
+/* iTime in seconds; the animation runs from 0 to the end of the timeline and holds there */
+void birthday_set_time(BirthdayRenderer* renderer, double seconds);
+void birthday_set_seed(BirthdayRenderer* renderer, unsigned int seed);
+
+/* Draws one frame into width x height at the origin of framebuffer (0 = the default framebuffer) */
+void birthday_render_into(BirthdayRenderer* renderer, unsigned int framebuffer);
+
+/* Why the last birthday_create() on this thread failed */
+const char* birthday_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIRTHDAY_RENDERER_H */
@@ -15,37 +15,42 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <random>
 #include <chrono>
 #include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "batch.h"
+#include "bench.h"
+#include "cpu_renderer.h"
+#include "dynamic_resolution.h"
+#include "frame_export.h"
+#include "frame_pacer.h"
+#include "gl_common.h"
+#include "headless.h"
+#include "mirror.h"
+#include "profile.h"
+#include "scene.h"
+#include "shader_reload.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "window_events.h"
 
 // Constant declarations
 constexpr uint32_t DEFAULT_WINDOW_WIDTH = 800;
 constexpr uint32_t DEFAULT_WINDOW_HEIGHT = 600;
 
-constexpr float ANIM_START = 1.0;           // Seconds
-constexpr float ANIM_DURATION = 9.0;
-
-constexpr float SCALE_START = 10.0;
-constexpr float SCALE_END = 1.5;
+constexpr uint32_t DEFAULT_CPU_FRAMES = 60;
+constexpr float DEFAULT_FPS = 60.0;
 
 const char* defaultWindowTitle = "Happy Birthday Sam!";
 
-// Vertex shader hard-coded GLSL
-const char* vertexShaderSource = R"(
-    #version 330 core
-    layout (location = 0) in vec2 aPos;
-    out vec2 fragCoord;
-    uniform vec2 iResolution;
-
-    void main() {
-        gl_Position = vec4(aPos, 0.0, 1.0);
-        fragCoord = (aPos + 1.0) * 0.5 * iResolution; // Convert from [-1,1] to [0,screenSize]
-    }
-)";
-
 // Global variables
 GLFWwindow* window = nullptr;
 int defaultWindowX = 0;
@@ -55,57 +60,409 @@ uint32_t swapInterval = 1;                  // 0 = vsync OFF, 1 = vsync ON
 bool showFPS = false;
 double prevTime = 0.0;
 uint32_t frameCounter = 0;
-float scale = SCALE_START;
+Scene* scene = nullptr;                     // The window's; holds uRandom, so a reloaded shader keeps it
+bool exporting = false;                     // Window size is locked while frames are being streamed out
+DynamicResolution* dynamicResolution = nullptr;
+bool dynamicResolutionDefault = true;       // What R goes back to
+FramePacer* framePacer = nullptr;
+Tracer* tracer = nullptr;                   // --trace; spans are skipped without one
+std::function<void()> snapshotTrace;        // T: write out what the trace holds so far
 
-// Screw C++17 requirements just for a simple 'minmax' :-p
-float clamp(float val, float min, float max) {
-    return (val < min) ? min : (val > max) ? max : val;
-}
+// Everything above is the render thread's once it starts; the callbacks reach it through these
+WindowCommandQueue windowCommands;
+std::vector<WindowCommand> commandBacklog;  // Main thread: commands the full queue had no room for yet
+WindowTitleQueue windowTitles;
 
-std::string findShaderFile(const std::string& filename) {
-    // First, try opening the file in the current working directory
-    std::ifstream file(filename);
-    if (file.good()) {
-        return filename;
-    }
+// Seeded with the time since the dawn of Mankind unless --seed pins it
+std::mt19937 rng(static_cast<uint32_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
 
-    // If still not found, return an empty string to indicate failure
-    return "";
+// Command line settings
+struct Options {
+    bool cpu = false;                       // --cpu: software renderer, no OpenGL needed
+    bool headless = false;                  // --headless: EGL + FBO, no window
+    bool bench = false;                     // --bench: fixed timestep, seeded, timed, JSON report
+    bool profile = false;                   // --profile: GPU cost of each section of the shader
+    bool mirror = false;                    // --mirror: draw once a frame, show it in a window per display
+    std::vector<MirrorRegion> mirrorRegions;    // Empty: one window per monitor
+    std::vector<int> mirrorSwapIntervals = { 1, 0 };
+    std::string batchPath;                  // --batch: job list of seeds, sizes and times to render stills of
+    ImageFormat imageFormat = IMAGE_PNG;
+    uint32_t width = DEFAULT_WINDOW_WIDTH;
+    uint32_t height = DEFAULT_WINDOW_HEIGHT;
+    uint32_t frames = DEFAULT_CPU_FRAMES;
+    uint32_t threads = 0;                   // 0 = all hardware threads
+    bool simd = true;
+    float startTime = 0.0f;
+    float endTime = -1.0f;                  // Below 0: the end of the timeline
+    float fps = DEFAULT_FPS;
+    std::string outputPath;
+    ExportFormat exportFormat = EXPORT_NONE;
+    bool seeded = false;
+    uint32_t seed = BENCH_DEFAULT_SEED;
+    std::vector<BenchResolution> benchSizes = { { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+    bool dynamicResolution = true;
+    bool renderThread = true;               // --single-thread: draw on the main thread between event polls
+    float frameBudget = DYNAMIC_RES_DEFAULT_BUDGET_MS;
+    float maxFps = -1.0f;                   // Below 0: the monitor's refresh rate
+    float idleFps = PACER_DEFAULT_IDLE_FPS;
+    std::string tracePath;                  // --trace: Chrome trace JSON of startup and the frames
+    std::string telemetryName;              // --telemetry: shared memory every frame's stats are published in
+    std::string shaderPath;                 // --shader: load from disk and hot-reload; built-in copy if empty
+    std::string messagePath;                // Letter table; built-in birthday.letters if empty
+    std::string timelinePath;               // Keyframes; built-in birthday.timeline if empty
+    LetterCode letterCode = LETTER_CODE_DEFAULT;
+    bool compareLetterCode = false;         // --letter-code both, --bench only
+    LetterMode letters = LETTERS_DEFAULT;
+    bool compareLetters = false;            // --letters both, --bench only
+    bool letterCulling = true;
+    BackgroundMode background = BACKGROUND_DEFAULT;
+    bool compareBackgrounds = false;        // --background both, --bench only
+    float backgroundScale = BACKGROUND_DEFAULT_SCALE;
+    AntialiasMode antialias = ANTIALIAS_DEFAULT;
+    bool compareAntialias = false;          // --aa all, --bench only
+    ShaderPrecision precision = PRECISION_DEFAULT;
+    bool comparePrecision = false;          // --precision all, --bench only
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]" << std::endl <<
+        "  (no options)       open a window and play the animation" << std::endl <<
+        "  --cpu              render on the CPU without OpenGL and report thread scaling" << std::endl <<
+        "  --headless         render offscreen through EGL (no window or display needed)" << std::endl <<
+        "  --bench            time every frame of --time at a fixed 1/--fps step and print JSON;" << std::endl <<
+        "                     combine with --headless to run without a display" << std::endl <<
+        "  --profile          time the shader headless with each section left out in turn (the background," <<
+            std::endl <<
+        "                     every letter, the shadows, outlines and fills) over --time at --size and print" <<
+            std::endl <<
+        "                     what each costs, most expensive first, for the whole range and each quarter" << std::endl <<
+        "  --mirror WHERE     draw every frame once and show it in a borderless window on every monitor, or on" <<
+            std::endl <<
+        "                     every region of a list such as 1920x1080+0+0,1920x1080+1920+0; on exit report each" <<
+            std::endl <<
+        "                     window's present cost and the GPU time against one process per window" << std::endl <<
+        "  --mirror-swap LIST swap interval of each --mirror window, the last for the rest (default 1,0: only" <<
+            std::endl <<
+        "                     the first waits for vsync, so a frame doesn't wait once per window)" << std::endl <<
+        "  --batch FILE       render a still for every seed, size and time in a job list" << std::endl <<
+        "                     (see birthday.batch) on --threads headless contexts, or CPU workers" << std::endl <<
+        "                     with --cpu, into the directory --out (default: the current one)" << std::endl <<
+        "  --format FORMAT    image format for --batch: png or ppm (default png)" << std::endl <<
+        "  --sizes LIST       resolutions for --bench (default 1280x720,1920x1080,3840x2160)" << std::endl <<
+        "  --budget MS        GPU time per frame the window's dynamic resolution aims for (default " <<
+            DYNAMIC_RES_DEFAULT_BUDGET_MS << ")" << std::endl <<
+        "  --fixed-resolution always render the window at its full size" << std::endl <<
+        "  --max-fps N        frame rate limit with vsync off; 0 for none (default the monitor's refresh rate)" << std::endl <<
+        "  --idle-fps N       frame rate while the window is unfocused or iconified (default " <<
+            PACER_DEFAULT_IDLE_FPS << ")" << std::endl <<
+        "  --single-thread    draw the window on the main thread between event polls instead of on a render thread" <<
+            std::endl <<
+        "  --trace FILE       record startup and every frame (CPU and GPU) and write them to FILE as Chrome" <<
+            std::endl <<
+        "                     trace JSON on exit; T writes FILE-1, FILE-2... while running" << std::endl <<
+        "  --telemetry NAME   publish every frame's timing, resolution, vsync state and dropped frames in shared" <<
+            std::endl <<
+        "                     memory NAME, for telemetry_reader to turn into Prometheus metrics" << std::endl <<
+        "  --shader FILE      load the shader (and what it #includes) from FILE instead of the copy built in," << std::endl <<
+        "                     and reload it whenever it is saved" << std::endl <<
+        "  --message FILE     letter table to show instead of birthday.letters (same format)" << std::endl <<
+        "  --timeline FILE    keyframes to animate with instead of birthday.timeline (same format)" << std::endl <<
+        "  --letter-code CODE unrolled (the table written into the shader) or uniforms (one shader for any table);" << std::endl <<
+        "                     --bench also takes both, to time each (default " << letterCodeName(LETTER_CODE_DEFAULT) << ")" <<
+            std::endl <<
+        "  --letters MODE     analytic (per-pixel letter functions) or atlas (baked distance field);" << std::endl <<
+        "                     --bench also takes both, to time each and measure the atlas error (default " <<
+            letterModeName(LETTERS_DEFAULT) << ")" << std::endl <<
+        "  --no-cull          run every letter at every pixel instead of only where it can show" << std::endl <<
+        "  --background MODE  inline (in the main pass) or layer (own pass at --background-scale, noise table);" << std::endl <<
+        "                     --bench also takes both, to time each and measure the layer error (default " <<
+            backgroundModeName(BACKGROUND_DEFAULT) << ")" << std::endl <<
+        "  --background-scale F  size of the background layer relative to the frame (default " <<
+            BACKGROUND_DEFAULT_SCALE << ")" << std::endl <<
+        "  --aa MODE          off, edge (supersample only pixels on the letters' edges) or full (every pixel);" <<
+            std::endl <<
+        "                     --bench also takes all, to time each, measure off and edge against full and" << std::endl <<
+        "                     report how much of the frame edge supersamples (default " <<
+            antialiasModeName(ANTIALIAS_DEFAULT) << ")" << std::endl <<
+        "  --precision TIER   high, medium (mediump hot paths) or half (medium rounded to half floats, what" <<
+            std::endl <<
+        "                     medium looks like on GPUs that honour it); --bench also takes all, to time each" <<
+            std::endl <<
+        "                     and measure medium and half against high (default " <<
+            shaderPrecisionName(PRECISION_DEFAULT) << ")" << std::endl <<
+        "  --seed N           fixed uRandom seed (--bench defaults to " << BENCH_DEFAULT_SEED << ")" << std::endl <<
+        "  --size WxH         resolution for --cpu/--headless (default " << DEFAULT_WINDOW_WIDTH << "x" <<
+            DEFAULT_WINDOW_HEIGHT << ")" << std::endl <<
+        "  --time START:END   iTime range in seconds for --headless/--bench (default 0 to the end of the timeline)" <<
+            std::endl <<
+        "  --fps N            frames per second of iTime for --headless/--bench (default " << DEFAULT_FPS << ")" << std::endl <<
+        "  --frames N         frames per thread count for --cpu (default " << DEFAULT_CPU_FRAMES << ")" << std::endl <<
+        "  --threads N        highest thread count for --cpu (default: all hardware threads); workers" << std::endl <<
+        "                     for --batch (default " << BATCH_DEFAULT_CONTEXTS << " contexts, or all hardware threads with --cpu)" <<
+        std::endl <<
+        "  --scalar           disable the AVX2 path of --cpu" << std::endl <<
+        "  --out FILE.ppm     write the last frame to a PPM image; with --headless a pattern" << std::endl <<
+        "                     such as frame_%04d.ppm writes every frame" << std::endl <<
+        "  --export FORMAT    stream every frame as y4m or rgba to --out (default: stdout)," << std::endl <<
+        "                     e.g. --headless --export y4m | ffmpeg -i - birthday.mp4" << std::endl <<
+        "                     --bench writes its JSON report to --out instead of stdout" << std::endl;
 }
 
-std::string loadShaderSource(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file) {
-        std::cerr << "Failed to open shader file: " << filename << std::endl;
-        exit(1);
+bool parseSize(const char* text, uint32_t& width, uint32_t& height) {
+    unsigned w = 0, h = 0;
+    if ((sscanf(text, "%ux%u", &w, &h) != 2) || (w == 0) || (h == 0)) {
+        return false;
     }
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+    width = w;
+    height = h;
+    return true;
 }
 
-void checkShaderCompilation(GLuint shader) {
-    int success;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
-        std::cerr << "Shader Compilation Error:\n" << infoLog << std::endl;
-        exit(1);
+bool parseTimeRange(const char* text, float& start, float& end) {
+    float a = 0.0f, b = 0.0f;
+    if ((sscanf(text, "%f:%f", &a, &b) != 2) || (a < 0.0f) || (b <= a)) {
+        return false;
     }
+    start = a;
+    end = b;
+    return true;
 }
 
-void setUniformRandom() {
-    int shaderProgram = 0;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &shaderProgram);
-    int randomLocation = glGetUniformLocation(shaderProgram, "uRandom");
+// Returns false (after printing why) if the command line can't be used
+bool parseArgs(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool needsValue = (strcmp(arg, "--size") == 0) || (strcmp(arg, "--frames") == 0) ||
+            (strcmp(arg, "--threads") == 0) || (strcmp(arg, "--out") == 0) ||
+            (strcmp(arg, "--time") == 0) || (strcmp(arg, "--fps") == 0) || (strcmp(arg, "--export") == 0) ||
+            (strcmp(arg, "--seed") == 0) || (strcmp(arg, "--sizes") == 0) || (strcmp(arg, "--budget") == 0) ||
+            (strcmp(arg, "--letters") == 0) || (strcmp(arg, "--background") == 0) ||
+            (strcmp(arg, "--background-scale") == 0) || (strcmp(arg, "--message") == 0) ||
+            (strcmp(arg, "--timeline") == 0) || (strcmp(arg, "--shader") == 0) || (strcmp(arg, "--trace") == 0) ||
+            (strcmp(arg, "--max-fps") == 0) || (strcmp(arg, "--idle-fps") == 0) ||
+            (strcmp(arg, "--letter-code") == 0) || (strcmp(arg, "--batch") == 0) || (strcmp(arg, "--format") == 0) ||
+            (strcmp(arg, "--aa") == 0) || (strcmp(arg, "--telemetry") == 0) || (strcmp(arg, "--precision") == 0) ||
+            (strcmp(arg, "--mirror") == 0) || (strcmp(arg, "--mirror-swap") == 0);
+        if (needsValue && !value) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
 
-    // Seed with current time since the dawn of Mankind
-    static std::mt19937 rng(std::chrono::steady_clock::now().time_since_epoch().count());
+        if (strcmp(arg, "--cpu") == 0) {
+            options.cpu = true;
+        } else if (strcmp(arg, "--headless") == 0) {
+            options.headless = true;
+        } else if (strcmp(arg, "--bench") == 0) {
+            options.bench = true;
+        } else if (strcmp(arg, "--profile") == 0) {
+            options.profile = true;
+        } else if (strcmp(arg, "--mirror") == 0) {
+            if (!parseMirrorRegions(value, options.mirrorRegions)) {
+                std::cerr << "Invalid mirror regions: " << value <<
+                    " (expected monitors or e.g. 1920x1080+0+0,1920x1080+1920+0)" << std::endl;
+                return false;
+            }
+            options.mirror = true;
+            i++;
+        } else if (strcmp(arg, "--mirror-swap") == 0) {
+            if (!parseSwapIntervals(value, options.mirrorSwapIntervals)) {
+                std::cerr << "Invalid swap intervals: " << value << " (expected e.g. 1,0)" << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--batch") == 0) {
+            options.batchPath = value;
+            i++;
+        } else if (strcmp(arg, "--format") == 0) {
+            if (!parseImageFormat(value, options.imageFormat)) {
+                std::cerr << "Invalid image format: " << value << " (expected png or ppm)" << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--sizes") == 0) {
+            if (!parseResolutionList(value, options.benchSizes)) {
+                std::cerr << "Invalid size list: " << value << " (expected e.g. 1280x720,1920x1080)" << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--budget") == 0) {
+            options.frameBudget = static_cast<float>(atof(value));
+            if (options.frameBudget <= 0.0f) {
+                std::cerr << "Invalid frame budget: " << value << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--max-fps") == 0) {
+            options.maxFps = static_cast<float>(atof(value));
+            if (options.maxFps < 0.0f) {
+                std::cerr << "Invalid frame rate limit: " << value << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--idle-fps") == 0) {
+            options.idleFps = static_cast<float>(atof(value));
+            if (options.idleFps <= 0.0f) {
+                std::cerr << "Invalid idle frame rate: " << value << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--fixed-resolution") == 0) {
+            options.dynamicResolution = false;
+        } else if (strcmp(arg, "--single-thread") == 0) {
+            options.renderThread = false;
+        } else if (strcmp(arg, "--no-cull") == 0) {
+            options.letterCulling = false;
+        } else if (strcmp(arg, "--trace") == 0) {
+            options.tracePath = value;
+            i++;
+        } else if (strcmp(arg, "--telemetry") == 0) {
+            options.telemetryName = value;
+            i++;
+        } else if (strcmp(arg, "--shader") == 0) {
+            options.shaderPath = value;
+            i++;
+        } else if (strcmp(arg, "--message") == 0) {
+            options.messagePath = value;
+            i++;
+        } else if (strcmp(arg, "--timeline") == 0) {
+            options.timelinePath = value;
+            i++;
+        } else if (strcmp(arg, "--letter-code") == 0) {
+            options.compareLetterCode = (strcmp(value, "both") == 0);
+            if (!options.compareLetterCode && !parseLetterCode(value, options.letterCode)) {
+                std::cerr << "Invalid letter code: " << value << " (expected unrolled, uniforms or both)" << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--letters") == 0) {
+            options.compareLetters = (strcmp(value, "both") == 0);
+            if (!options.compareLetters && !parseLetterMode(value, options.letters)) {
+                std::cerr << "Invalid letter mode: " << value << " (expected analytic, atlas or both)" << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--background") == 0) {
+            options.compareBackgrounds = (strcmp(value, "both") == 0);
+            if (!options.compareBackgrounds && !parseBackgroundMode(value, options.background)) {
+                std::cerr << "Invalid background mode: " << value << " (expected inline, layer or both)" << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--aa") == 0) {
+            options.compareAntialias = (strcmp(value, "all") == 0);
+            if (!options.compareAntialias && !parseAntialiasMode(value, options.antialias)) {
+                std::cerr << "Invalid anti-aliasing mode: " << value << " (expected off, edge, full or all)" << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--precision") == 0) {
+            options.comparePrecision = (strcmp(value, "all") == 0);
+            if (!options.comparePrecision && !parseShaderPrecision(value, options.precision)) {
+                std::cerr << "Invalid precision: " << value << " (expected high, medium, half or all)" << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--background-scale") == 0) {
+            options.backgroundScale = static_cast<float>(atof(value));
+            if ((options.backgroundScale <= 0.0f) || (options.backgroundScale > 1.0f)) {
+                std::cerr << "Invalid background scale: " << value << " (expected more than 0, up to 1)" << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--seed") == 0) {
+            options.seed = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            options.seeded = true;
+            i++;
+        } else if (strcmp(arg, "--size") == 0) {
+            if (!parseSize(value, options.width, options.height)) {
+                std::cerr << "Invalid size: " << value << " (expected e.g. 1920x1080)" << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--frames") == 0) {
+            options.frames = static_cast<uint32_t>(std::max(1, atoi(value)));
+            i++;
+        } else if (strcmp(arg, "--threads") == 0) {
+            options.threads = static_cast<uint32_t>(std::max(0, atoi(value)));
+            i++;
+        } else if (strcmp(arg, "--time") == 0) {
+            if (!parseTimeRange(value, options.startTime, options.endTime)) {
+                std::cerr << "Invalid time range: " << value << " (expected e.g. 0:10)" << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--fps") == 0) {
+            options.fps = static_cast<float>(atof(value));
+            if (options.fps <= 0.0f) {
+                std::cerr << "Invalid frame rate: " << value << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--scalar") == 0) {
+            options.simd = false;
+        } else if (strcmp(arg, "--out") == 0) {
+            options.outputPath = value;
+            i++;
+        } else if (strcmp(arg, "--export") == 0) {
+            if (!parseExportFormat(value, options.exportFormat)) {
+                std::cerr << "Invalid export format: " << value << " (expected y4m or rgba)" << std::endl;
+                return false;
+            }
+            i++;
+        } else {
+            if ((strcmp(arg, "--help") != 0) && (strcmp(arg, "-h") != 0)) {
+                std::cerr << "Unknown option: " << arg << std::endl;
+            }
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    if (options.profile && (options.bench || options.cpu || !options.batchPath.empty())) {
+        std::cerr << "--profile renders headless already and can't be combined with --bench, --batch or --cpu" << std::endl;
+        return false;
+    }
+    if (options.mirror && (options.bench || options.profile || options.cpu || options.headless ||
+                           !options.batchPath.empty() || (options.exportFormat != EXPORT_NONE))) {
+        std::cerr << "--mirror opens windows of its own and can't be combined with --bench, --profile, --batch, --cpu, "
+            "--headless or --export" << std::endl;
+        return false;
+    }
+    if (!options.batchPath.empty() && (options.bench || options.headless)) {
+        std::cerr << "--batch renders headless already and can't be combined with --bench or --headless" << std::endl;
+        return false;
+    }
+    if (options.compareLetterCode && !options.bench) {
+        std::cerr << "--letter-code both only works with --bench" << std::endl;
+        return false;
+    }
+    if (options.compareLetters && !options.bench) {
+        std::cerr << "--letters both only works with --bench" << std::endl;
+        return false;
+    }
+    if (options.compareBackgrounds && !options.bench) {
+        std::cerr << "--background both only works with --bench" << std::endl;
+        return false;
+    }
+    if (options.compareAntialias && !options.bench) {
+        std::cerr << "--aa all only works with --bench" << std::endl;
+        return false;
+    }
+    if (options.comparePrecision && !options.bench) {
+        std::cerr << "--precision all only works with --bench" << std::endl;
+        return false;
+    }
+    return true;
+}
 
-    // Set uniform to random distribution between 0.0 and 1.0
+float nextRandom() {
+    // Random distribution between 0.0 and 1.0
     std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-    glUniform1f(randomLocation, dist(rng));
+    return dist(rng);
+}
+
+void setUniformRandom() {
+    scene->setRandom(nextRandom());
 }
 
 void resetAnim() {
@@ -113,26 +470,97 @@ void resetAnim() {
     prevTime = 0.0;
     frameCounter = 0;
     glfwSetTime(0.0);
-    scale = SCALE_START;
     setUniformRandom();
 }
 
 void setWindowTitle() {
+    // Only the main thread may set it; the render thread's frame loop can't wait for that
+    WindowTitle title;
     if (showFPS) {
-        char title[64];
-        snprintf(title, sizeof(title), "%s  (FPS: %d)", defaultWindowTitle, frameCounter);
-        glfwSetWindowTitle(window, title);
+        snprintf(title.text, sizeof(title.text), "%s  (FPS: %d, %s)", defaultWindowTitle, frameCounter,
+                 dynamicResolution->status().c_str());
     } else {
-        glfwSetWindowTitle(window, defaultWindowTitle);
+        snprintf(title.text, sizeof(title.text), "%s", defaultWindowTitle);
+    }
+    windowTitles.push(title);
+    glfwPostEmptyEvent();
+}
+
+// Main thread: set the titles the render thread asked for
+void showWindowTitles() {
+    WindowTitle title;
+    while (windowTitles.pop(title)) {
+        glfwSetWindowTitle(window, title.text);
+    }
+}
+
+// Main thread: pass a command on to the render thread, in order, holding it back while the queue is full
+void sendCommand(WindowCommandType type, int width = 0, int height = 0) {
+    WindowCommand command = { type, width, height, std::chrono::steady_clock::now() };
+    if (!commandBacklog.empty() || !windowCommands.push(command)) {
+        commandBacklog.push_back(command);
+    }
+}
+
+void flushCommands() {
+    size_t sent = 0;
+    while ((sent < commandBacklog.size()) && windowCommands.push(commandBacklog[sent])) {
+        sent++;
     }
+    commandBacklog.erase(commandBacklog.begin(), commandBacklog.begin() + sent);
 }
 
+// Render thread: act on a command before drawing the next frame
+void applyCommand(const WindowCommand& command) {
+    switch (command.type) {
+    case COMMAND_RESIZE:
+        // iResolution and the viewport follow the scaled size, set at the start of every frame
+        dynamicResolution->resize(command.width, command.height);
+        break;
+    case COMMAND_REPLAY:
+        resetAnim();
+        break;
+    case COMMAND_RESET:
+        swapInterval = 1;
+        glfwSwapInterval(swapInterval);
+        framePacer->setVsync(true);
+        dynamicResolution->setEnabled(dynamicResolutionDefault);
+        showFPS = false;
+        setWindowTitle();
+        resetAnim();
+        break;
+    case COMMAND_TOGGLE_VSYNC:
+        swapInterval = 1 - swapInterval;
+        glfwSwapInterval(swapInterval);
+        framePacer->setVsync(swapInterval != 0);
+        break;
+    case COMMAND_TOGGLE_DYNAMIC_RESOLUTION:
+        dynamicResolution->setEnabled(!dynamicResolution->enabled());
+        setWindowTitle();
+        break;
+    case COMMAND_TOGGLE_FPS:
+        showFPS = !showFPS;
+        setWindowTitle();
+        prevTime = glfwGetTime();
+        frameCounter = 0;
+        break;
+    case COMMAND_FOCUS_GAINED:
+    case COMMAND_FOCUS_LOST:
+        framePacer->setFocused(command.type == COMMAND_FOCUS_GAINED);
+        break;
+    case COMMAND_ICONIFIED:
+    case COMMAND_RESTORED:
+        framePacer->setIconified(command.type == COMMAND_ICONIFIED);
+        break;
+    }
+} // applyCommand
+
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if ((action == GLFW_PRESS) || (action == GLFW_REPEAT)) {
         if (key == GLFW_KEY_Q) {
             // Press Q to close the app
             glfwSetWindowShouldClose(window, 1);
-        } else if (key == GLFW_KEY_F) {
+        } else if ((key == GLFW_KEY_F) && !exporting) {
             // Press F to toggle maximized window size or not
             int maximized = glfwGetWindowAttrib(window, GLFW_MAXIMIZED);
             if (maximized) {
@@ -142,50 +570,203 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
             }
         } else if (key == GLFW_KEY_R) {
             // Press R to reset window size and position to defaults
-            glfwSetWindowPos(window, defaultWindowX, defaultWindowY);
-            glfwSetWindowSize(window, DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT);
-            swapInterval = 1;
-            glfwSwapInterval(swapInterval);
-            showFPS = false;
-            setWindowTitle();
-            resetAnim();
+            if (!exporting) {
+                glfwSetWindowPos(window, defaultWindowX, defaultWindowY);
+                glfwSetWindowSize(window, DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT);
+            }
+            sendCommand(COMMAND_RESET);
         } else if (key == GLFW_KEY_SPACE) {
             // Press Space to rerun animation from time 0
-            resetAnim();
+            sendCommand(COMMAND_REPLAY);
         } else if (key == GLFW_KEY_V) {
             // Press V to enable/disable vsync
-            swapInterval = 1 - swapInterval;
-            glfwSwapInterval(swapInterval);
+            sendCommand(COMMAND_TOGGLE_VSYNC);
+        } else if (key == GLFW_KEY_D) {
+            // Press D to switch dynamic resolution on/off
+            sendCommand(COMMAND_TOGGLE_DYNAMIC_RESOLUTION);
         } else if (key == GLFW_KEY_S) {
             // Press S to show/hide FPS
-            showFPS = !showFPS;
-            setWindowTitle();
-            prevTime = glfwGetTime();
-            frameCounter = 0;
+            sendCommand(COMMAND_TOGGLE_FPS);
+        } else if ((key == GLFW_KEY_T) && (action == GLFW_PRESS) && snapshotTrace) {
+            // Press T to write out the trace so far; safe while the render thread keeps recording
+            snapshotTrace();
         }
     }
 } // keyCallback
 
 void framebufferResizeCallback(GLFWwindow* window, int width, int height)
 {
-    // Update uniform
-    int shaderProgram = 0;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &shaderProgram);
-    int resolutionLocation = glGetUniformLocation(shaderProgram, "iResolution");
-    glUniform2f(resolutionLocation, static_cast<float>(width), static_cast<float>(height));
-    // Update viewport size
-    glViewport(0, 0, width, height);
+    sendCommand(COMMAND_RESIZE, width, height);
+}
+
+void windowFocusCallback(GLFWwindow* window, int focused)
+{
+    sendCommand(focused ? COMMAND_FOCUS_GAINED : COMMAND_FOCUS_LOST);
 }
 
-float easeOutCubic(float t) {
-    return 1 - pow(1.0 - t, 3);
+void windowIconifyCallback(GLFWwindow* window, int iconified)
+{
+    sendCommand(iconified ? COMMAND_ICONIFIED : COMMAND_RESTORED);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        return 1;
+    }
+
+    if (options.seeded || options.bench || options.profile) {
+        rng.seed(options.seed);
+    }
+
+    // The message and the timeline, built in like the shader unless given as files
+    SceneOptions sceneOptions;
+    std::string contentError;
+    if (!loadSceneContent(options.messagePath, options.timelinePath, sceneOptions.message, sceneOptions.timeline,
+                          contentError)) {
+        std::cerr << contentError << std::endl;
+        return 1;
+    }
+    const LetterTable& message = sceneOptions.message;
+    const Timeline& timeline = sceneOptions.timeline;
+    if (options.endTime < 0.0f) {
+        options.endTime = timeline.end();
+    }
+    sceneOptions.letterCode = options.letterCode;
+    sceneOptions.letters = options.letters;
+    sceneOptions.letterCulling = options.letterCulling;
+    sceneOptions.background = options.background;
+    sceneOptions.backgroundScale = options.backgroundScale;
+    sceneOptions.antialias = options.antialias;
+    sceneOptions.precision = options.precision;
+
+    if (options.bench) {
+        BenchOptions benchOptions;
+        benchOptions.resolutions = options.benchSizes;
+        benchOptions.headless = options.headless;
+        benchOptions.startTime = options.startTime;
+        benchOptions.endTime = options.endTime;
+        benchOptions.fps = options.fps;
+        benchOptions.seed = options.seed;
+        benchOptions.uRandom = nextRandom();
+        benchOptions.outputPath = options.outputPath;
+        benchOptions.shaderPath = options.shaderPath;
+        benchOptions.message = message;
+        benchOptions.timeline = timeline;
+        if (options.compareLetterCode) {
+            benchOptions.letterCodes = { LETTER_CODE_UNROLLED, LETTER_CODE_UNIFORMS };
+        } else {
+            benchOptions.letterCodes = { options.letterCode };
+        }
+        if (options.compareLetters) {
+            benchOptions.letterModes = { LETTERS_ANALYTIC, LETTERS_ATLAS };
+        } else {
+            benchOptions.letterModes = { options.letters };
+        }
+        benchOptions.letterCulling = options.letterCulling;
+        if (options.compareBackgrounds) {
+            benchOptions.backgroundModes = { BACKGROUND_INLINE, BACKGROUND_LAYER };
+        } else {
+            benchOptions.backgroundModes = { options.background };
+        }
+        if (options.compareAntialias) {
+            benchOptions.antialiasModes = { ANTIALIAS_FULL, ANTIALIAS_EDGE, ANTIALIAS_OFF };
+        } else {
+            benchOptions.antialiasModes = { options.antialias };
+        }
+        if (options.comparePrecision) {
+            benchOptions.precisions = { PRECISION_HIGH, PRECISION_MEDIUM, PRECISION_HALF };
+        } else {
+            benchOptions.precisions = { options.precision };
+        }
+        benchOptions.backgroundScale = options.backgroundScale;
+        return runBenchMode(benchOptions);
+    }
+
+    if (options.profile) {
+        ProfileOptions profileOptions;
+        profileOptions.width = options.width;
+        profileOptions.height = options.height;
+        profileOptions.startTime = options.startTime;
+        profileOptions.endTime = options.endTime;
+        profileOptions.fps = options.fps;
+        profileOptions.uRandom = nextRandom();
+        profileOptions.shaderPath = options.shaderPath;
+        profileOptions.scene = sceneOptions;
+        return runProfileMode(profileOptions);
+    }
+
+    if (!options.batchPath.empty()) {
+        BatchOptions batchOptions;
+        std::string batchError;
+        if (!loadBatchJobs(options.batchPath, batchOptions.jobs, batchError)) {
+            std::cerr << batchError << std::endl;
+            return 1;
+        }
+        batchOptions.outputDirectory = options.outputPath;
+        batchOptions.format = options.imageFormat;
+        batchOptions.cpu = options.cpu;
+        batchOptions.workers = options.threads;
+        batchOptions.allowSIMD = options.simd;
+        batchOptions.shaderPath = options.shaderPath;
+        batchOptions.scene = sceneOptions;
+        return runBatchMode(batchOptions);
+    }
+
+    if (options.cpu) {
+        CpuModeOptions cpuOptions;
+        cpuOptions.width = options.width;
+        cpuOptions.height = options.height;
+        cpuOptions.frames = options.frames;
+        cpuOptions.maxThreads = options.threads;
+        cpuOptions.allowSIMD = options.simd;
+        cpuOptions.uRandom = nextRandom();
+        cpuOptions.message = message;
+        cpuOptions.timeline = timeline;
+        cpuOptions.outputPath = options.outputPath;
+        return runCpuMode(cpuOptions);
+    }
+
+    if (options.headless) {
+        HeadlessOptions headlessOptions;
+        headlessOptions.width = options.width;
+        headlessOptions.height = options.height;
+        headlessOptions.startTime = options.startTime;
+        headlessOptions.endTime = options.endTime;
+        headlessOptions.fps = options.fps;
+        headlessOptions.uRandom = nextRandom();
+        headlessOptions.outputPattern = options.outputPath;
+        headlessOptions.exportFormat = options.exportFormat;
+        headlessOptions.shaderPath = options.shaderPath;
+        headlessOptions.scene = sceneOptions;
+        return runHeadlessMode(headlessOptions);
+    }
+
+    if (options.mirror) {
+        MirrorOptions mirrorOptions;
+        mirrorOptions.regions = options.mirrorRegions;
+        mirrorOptions.swapIntervals = options.mirrorSwapIntervals;
+        mirrorOptions.uRandom = nextRandom();
+        mirrorOptions.shaderPath = options.shaderPath;
+        mirrorOptions.scene = sceneOptions;
+        return runMirrorMode(mirrorOptions);
+    }
+
+    // Allocated up front, so only with --trace
+    std::unique_ptr<Tracer> trace;
+    if (!options.tracePath.empty()) {
+        trace.reset(new Tracer());
+        tracer = trace.get();
+        tracer->nameThread("main");
+    }
+    TraceSpan startupSpan(tracer, "startup");
+
+    TraceSpan initSpan(tracer, "glfwInit");
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
         return -1;
     }
+    initSpan.finish();
 
     // Ask for OpenGL version 3.3
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -193,6 +774,13 @@ int main() {
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 
+    // Every exported frame has to be the same size
+    exporting = (options.exportFormat != EXPORT_NONE);
+    if (exporting) {
+        glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    }
+
+    TraceSpan windowSpan(tracer, "create window");
     window = glfwCreateWindow(DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT, defaultWindowTitle, nullptr, nullptr);
     if (!window) {
         std::cerr << "Failed to create GLFW window" << std::endl;
@@ -200,6 +788,7 @@ int main() {
         return -1;
     }
     glfwMakeContextCurrent(window);
+    windowSpan.finish();
 
     // std::cout << "GL_VERSION: " << glGetString(GL_VERSION) << std::endl;
 
@@ -212,66 +801,89 @@ int main() {
     // Set callback functions
     glfwSetFramebufferSizeCallback(window, framebufferResizeCallback);
     glfwSetKeyCallback(window, keyCallback);
+    glfwSetWindowFocusCallback(window, windowFocusCallback);
+    glfwSetWindowIconifyCallback(window, windowIconifyCallback);
 
-    if (glewInit() != GLEW_OK) {
+    TraceSpan glewSpan(tracer, "glewInit");
+    if (!initGLEW()) {
         std::cerr << "Failed to initialize GLEW" << std::endl;
         return -1;
     }
+    glewSpan.finish();
+    GpuTrace gpuTrace;
+    gpuTrace.create(tracer);
 
-    // Load and compile fragment shader from file
-    std::string shaderFile = findShaderFile("birthday.shader");
-    if (shaderFile.empty()) {
-        std::cerr << "Failed to find shader file: birthday.shader\n";
-        return 1;
-    }
-    std::string fragmentShaderStr = loadShaderSource(shaderFile);
-    const char* fragmentShaderSource = fragmentShaderStr.c_str();
-    
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
-    checkShaderCompilation(vertexShader);
+    // Load the fragment shader: the built-in one, or --shader from disk
+    const std::string& shaderFile = options.shaderPath;
+    TraceSpan loadSpan(tracer, "load shader");
+    std::string shaderSource = loadShaderSource(shaderFile);
+    loadSpan.finish();
+
+    // Keep stdout clean when exported frames go there
+    std::string exportPath = options.outputPath.empty() ? "-" : options.outputPath;
+    bool consoleOnStderr = exporting && (exportPath == "-");
+    std::ostream& console = consoleOnStderr ? std::cerr : std::cout;
 
     // Hide all errors from this point forward to prevent messages showing in terminal
     //  (some kind of bug in Sequoia since December 2024 apparently
     //  e.g. https://github.com/processing/processing4/issues/864 )
-    freopen("/dev/null", "w", stderr);
-
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fragmentShader);
-    checkShaderCompilation(fragmentShader);
-
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    // Initialize shader uniforms
-    int resolutionLocation = glGetUniformLocation(shaderProgram, "iResolution");
-    int scaleLocation = glGetUniformLocation(shaderProgram, "uScale");
-    int timeLocation = glGetUniformLocation(shaderProgram, "iTime");
-    glUseProgram(shaderProgram);
-
-    // Set resolution uniform for shaders
-    glUniform2f(resolutionLocation, static_cast<float>(DEFAULT_WINDOW_WIDTH), 
-        static_cast<float>(DEFAULT_WINDOW_HEIGHT));
-    glUniform1f(scaleLocation, scale);
+    // unless stderr is where the console went, so the export and pacing reports still reach it
+    if (!consoleOnStderr) {
+        freopen("/dev/null", "w", stderr);
+    }
+
+    // The program, the Animation block, the letter textures (from unit 1, so they stay bound under the upscale
+    // pass on unit 0) and the background pass
+    Scene windowScene;
+    std::string sceneError;
+    if (!windowScene.create(sceneOptions, shaderSource, console, sceneError, tracer)) {
+        console << sceneError << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    scene = &windowScene;
     setUniformRandom();
 
-    float vertices[] = { -1.0f, -1.0f,  1.0f, -1.0f,  -1.0f, 1.0f,  1.0f, 1.0f };
-    GLuint VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
+    // The framebuffer can be larger than the window on high-DPI screens
+    int framebufferWidth = 0, framebufferHeight = 0;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    DynamicResolution resolution;
+    resolution.create(framebufferWidth, framebufferHeight, options.frameBudget);
+    dynamicResolutionDefault = options.dynamicResolution;
+    resolution.setEnabled(dynamicResolutionDefault);
+    dynamicResolution = &resolution;
+
+    // Without vsync, hold the window to the monitor's refresh rate unless told otherwise
+    const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    double refreshRate = (mode && (mode->refreshRate > 0)) ? mode->refreshRate : 0.0;
+    double maxFps = (options.maxFps >= 0.0f) ? options.maxFps : ((refreshRate > 0.0) ? refreshRate : PACER_DEFAULT_LIMIT_FPS);
+    FramePacer pacer;
+    pacer.configure(maxFps, options.idleFps, refreshRate);
+    pacer.setVsync(swapInterval != 0);
+    framePacer = &pacer;
+
+    // Monitoring reads this instead of the window title; the display runs on without it if it can't be made
+    TelemetryWriter telemetry;
+    if (!options.telemetryName.empty()) {
+        std::string error;
+        if (telemetry.create(options.telemetryName, error)) {
+            console << "Publishing frame telemetry as " << options.telemetryName << std::endl;
+        } else {
+            console << "No telemetry: " << error << std::endl;
+        }
+    }
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    FrameExporter exporter;
+    if (exporting) {
+        if (!exporter.open(exportPath, options.exportFormat, framebufferWidth, framebufferHeight, options.fps)) {
+            console << "Failed to open export output: " << exportPath << std::endl;
+            glfwTerminate();
+            return 1;
+        }
+    }
 
     // Print usage instructions to stdout
-    std::cout << std::endl << "******** Birthday Shader 2025! ********       " << VERSION << std::endl <<
+    console << std::endl << "******** Birthday Shader 2025! ********       " << VERSION << std::endl <<
         "Happy Birthday, Sam!   from Uncle Brian" << std::endl <<
         "---------------------------------------" << std::endl <<
         "Press: ( Q )     to quit" << std::endl <<
@@ -279,12 +891,63 @@ int main() {
         "       ( F )     to toggle full window size" << std::endl <<
         "       ( S )     to show/hide frames per second" << std::endl <<
         "       ( V )     to toggle vsync on/off" << std::endl <<
-        "       ( R )     to reset everything back to default settings" << std::endl;
+        "       ( D )     to toggle dynamic resolution on/off" << std::endl <<
+        "       ( R )     to reset everything back to default settings" << std::endl <<
+        (tracer ? "       ( T )     to write out the trace so far\n" : "") <<
+        (shaderFile.empty() ? std::string("Run with --shader birthday.shader to edit the shader live") :
+            "Saving " + shaderFile + " (or anything it includes) reloads it without restarting") << std::endl;
+
+    // Rebuild a shader from disk in the background whenever it is saved. Without parallel shader compile
+    // the worker thread needs its own context sharing objects with this one; GLFW can only create
+    // it here on the main thread, as an invisible window
+    GLFWwindow* compileWindow = nullptr;
+    if (!shaderFile.empty() && !parallelShaderCompileSupported()) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        compileWindow = glfwCreateWindow(1, 1, defaultWindowTitle, nullptr, window);
+        glfwMakeContextCurrent(window);
+    }
+    WorkerContext compileContext;
+    if (compileWindow) {
+        compileContext.bind = [compileWindow] { glfwMakeContextCurrent(compileWindow); return true; };
+        compileContext.release = [] { glfwMakeContextCurrent(nullptr); };
+    }
+    ShaderReloader reloader;
+    reloader.setDefines(windowScene.shaderDefines());
+    if (!shaderFile.empty()) {
+        reloader.start(shaderFile, windowScene.vertex(), compileContext, console);
+    }
 
     prevTime = glfwGetTime();
     float time = glfwGetTime();
 
-    while (!glfwWindowShouldClose(window)) {
+    if (tracer) {
+        snapshotTrace = [&options, &console] {
+            static uint32_t snapshots = 0;
+            const std::string& path = options.tracePath;
+            size_t dot = path.find_last_of('.');
+            size_t slash = path.find_last_of("/\\");
+            if ((dot == std::string::npos) || ((slash != std::string::npos) && (dot < slash))) {
+                dot = path.size();
+            }
+            tracer->write(path.substr(0, dot) + "-" + std::to_string(++snapshots) + path.substr(dot), console);
+        };
+    }
+
+    InputLatency latency;
+    bool firstFrame = true;
+    auto drawFrame = [&] {
+        TraceSpan frameSpan(tracer, firstFrame ? "first frame" : "frame");
+        firstFrame = false;
+
+        // Commands from the callbacks since the last frame
+        TraceSpan commandSpan(tracer, "commands");
+        WindowCommand command;
+        while (windowCommands.pop(command)) {
+            applyCommand(command);
+            latency.applied(command);
+        }
+        commandSpan.finish();
+
         // Show FPS if necessary
         double currentTime = glfwGetTime();
         if (showFPS) {
@@ -297,22 +960,130 @@ int main() {
             }
         }
 
-        // Update necessary uniforms each frame
-        glUniform1f(timeLocation, currentTime);
+        // Switch to a freshly reloaded shader; the animation carries on where it was
+        TraceSpan reloadSpan(tracer, "shader reload");
+        GLuint reloadedProgram = 0;
+        if (reloader.poll(reloadedProgram)) {
+            windowScene.replaceProgram(reloadedProgram);
+
+            // The background pass is small enough to rebuild right here, from the same saved source
+            std::string source, error;
+            if (windowScene.backgroundLayer() && readShaderSource(shaderFile, source) &&
+                !windowScene.rebuildBackground(source, error)) {
+                console << "Background pass kept: " << error << std::endl;
+            }
+            console << "Reloaded " << shaderFile << std::endl;
+        }
+        reloadSpan.finish();
 
-        float t = (glfwGetTime() - ANIM_START) / ANIM_DURATION;
-        t = clamp(t, 0.0f, 1.0f);
-        float easedScale = SCALE_START + (SCALE_END - SCALE_START) * easeOutCubic(t);
-        glUniform1f(scaleLocation, easedScale);
+        // Render at the resolution the frame budget allows
+        uint32_t renderWidth = 0, renderHeight = 0;
+        resolution.beginFrame(renderWidth, renderHeight);
 
-        glClear(GL_COLOR_BUFFER_BIT);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        // Update necessary uniforms each frame
+        TraceSpan uniformSpan(tracer, "uniforms");
+        windowScene.update(static_cast<float>(currentTime), renderWidth, renderHeight);
+        uniformSpan.finish();
+        if (windowScene.backgroundLayer()) {
+            TraceSpan span(tracer, "background");
+            gpuTrace.begin("background");
+            windowScene.renderBackground();
+            gpuTrace.end();
+        }
+
+        TraceSpan drawSpan(tracer, "draw");
+        gpuTrace.begin("draw");
+        windowScene.draw();
+        resolution.endFrame();
+        gpuTrace.end();
+        drawSpan.finish();
+        if (exporting) {
+            TraceSpan span(tracer, "export");
+            exporter.capture();
+        }
+        TraceSpan paceSpan(tracer, "pace");
+        pacer.wait();
+        paceSpan.finish();
+        TraceSpan swapSpan(tracer, "swap");
         glfwSwapBuffers(window);
-        glfwPollEvents();
+        swapSpan.finish();
+        pacer.presented();
+        latency.presented();
+        gpuTrace.collect();
+        if (telemetry.active()) {
+            TelemetryFrame stats = {};
+            stats.gpuMilliseconds = resolution.enabled() ? resolution.controller().smoothedMilliseconds() : 0.0f;
+            stats.renderWidth = renderWidth;
+            stats.renderHeight = renderHeight;
+            resolution.outputSize(stats.outputWidth, stats.outputHeight);
+            stats.droppedFrames = pacer.droppedFrames();
+            if (pacer.vsyncOn()) {
+                stats.flags |= TELEMETRY_VSYNC;
+            }
+            if (pacer.idle()) {
+                stats.flags |= TELEMETRY_IDLE;
+            }
+            if (resolution.enabled()) {
+                stats.flags |= TELEMETRY_DYNAMIC_RESOLUTION;
+            }
+            telemetry.publish(stats);
+        }
+    };
+
+    if (options.renderThread) {
+        // The render thread takes the context over; this thread only waits for events, so dragging or
+        // resizing the window (which can hold the event loop for as long as it lasts) no longer stops the animation
+        glfwMakeContextCurrent(nullptr);
+        startupSpan.finish();
+        std::thread renderThread([&] {
+            if (tracer) {
+                tracer->nameThread("render");
+            }
+            glfwMakeContextCurrent(window);
+            while (!glfwWindowShouldClose(window)) {
+                drawFrame();
+            }
+            glfwMakeContextCurrent(nullptr);
+        });
+        while (!glfwWindowShouldClose(window)) {
+            TraceSpan pollSpan(tracer, "wait events");
+            glfwWaitEvents();
+            pollSpan.finish();
+            flushCommands();
+            showWindowTitles();
+        }
+        renderThread.join();
+        glfwMakeContextCurrent(window);
+    } else {
+        startupSpan.finish();
+        while (!glfwWindowShouldClose(window)) {
+            drawFrame();
+            TraceSpan pollSpan(tracer, "poll events");
+            glfwPollEvents();
+            pollSpan.finish();
+            flushCommands();
+            showWindowTitles();
+        }
     }
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    if (exporting) {
+        exporter.finish(console);
+    }
+    latency.report(console);
+    pacer.report(console);
+    framePacer = nullptr;
+    telemetry.destroy();
+    if (tracer) {
+        tracer->write(options.tracePath, console);
+        snapshotTrace = nullptr;
+        tracer = nullptr;
+    }
+    gpuTrace.destroy();
+    reloader.stop();
+    resolution.destroy();
+    dynamicResolution = nullptr;
+    windowScene.destroy();
+    scene = nullptr;
     glfwTerminate();
     return 0;
 } // main
@@ -0,0 +1,186 @@
+/*******************************************************************
+    Birthday Shader 2025 - multithreaded software renderer
+*******************************************************************/
+#include "cpu_renderer.h"
+#include "animation.h"
+#include "image_io.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace cpushader {
+
+namespace {
+
+// hash() from noise.glsl, remapped to a -1..1 gradient like noise() does
+void hashGradient(float px, float py, float& gx, float& gy) {
+    float hx = std::sin(px * 2127.1f + py * 81.17f) * 43758.5453f;
+    float hy = std::sin(px * 1269.5f + py * 283.37f) * 43758.5453f;
+    gx = -1.0f + 2.0f * (hx - std::floor(hx));
+    gy = -1.0f + 2.0f * (hy - std::floor(hy));
+}
+
+} // namespace
+
+void prepareFrame(const FrameUniforms& uniforms, FrameConstants& fc) {
+    fc.resX = uniforms.iResolution[0];
+    fc.resY = uniforms.iResolution[1];
+    fc.invResX = 1.0f / fc.resX;
+    fc.invResY = 1.0f / fc.resY;
+    fc.ratio = fc.resX / fc.resY;
+    fc.uvScale = uniforms.animation->uScale / fc.resY;
+
+    // drawBackground() calls noise() at p = ((iTime + uRandom * 2002.411) * 0.08, uv.x * uv.y).
+    // p.x is the same for every pixel and |uv.x * uv.y| <= .25, so floor(p.y) is -1 or 0 and
+    // only lattice rows -1, 0 and 1 are ever touched: fold them into a linear function of fract(p.y)
+    float px = (uniforms.iTime + uniforms.uRandom * 2002.411f) * 0.08f;
+    float ix = std::floor(px);
+    float fx = px - ix;
+    float ux = fx * fx * (3.0f - 2.0f * fx);
+    float rowA[3], rowB[3];
+    for (int row = -1; row <= 1; row++) {
+        float g0x, g0y, g1x, g1y;
+        hashGradient(ix, static_cast<float>(row), g0x, g0y);
+        hashGradient(ix + 1.0f, static_cast<float>(row), g1x, g1y);
+        rowA[row + 1] = g0x * fx * (1.0f - ux) + g1x * (fx - 1.0f) * ux;
+        rowB[row + 1] = g0y * (1.0f - ux) + g1y * ux;
+    }
+    fc.noiseA0[0] = rowA[0];  fc.noiseB0[0] = rowB[0];
+    fc.noiseA1[0] = rowA[1];  fc.noiseB1[0] = rowB[1];
+    fc.noiseA0[1] = rowA[1];  fc.noiseB0[1] = rowB[1];
+    fc.noiseA1[1] = rowA[2];  fc.noiseB1[1] = rowB[2];
+
+    fc.wavePhase = static_cast<float>(std::fmod(double(uniforms.iTime * 2.0f), 2.0 * 3.14159265358979));
+
+    fc.wobbleCos = std::cos(uniforms.animation->wobble);
+    fc.wobbleSin = std::sin(uniforms.animation->wobble);
+    fc.letters = uniforms.letters;
+    std::copy(uniforms.animation->offsets, uniforms.animation->offsets + LETTER_MAX, fc.offsets);
+}
+
+} // namespace cpushader
+
+namespace {
+
+bool cpuHasAVX2() {
+#if defined(_MSC_VER) && defined(_M_X64)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) && ((_xgetbv(0) & 0x6) == 0x6);
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5));
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+CpuRenderer::CpuRenderer(uint32_t threadCount, bool allowSIMD)
+    : pool(threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency())),
+      kernel(scalarKernel) {
+    if (allowSIMD && cpuHasAVX2() && cpushader::avx2Kernel()) {
+        kernel = cpushader::avx2Kernel();
+    }
+}
+
+void CpuRenderer::scalarKernel(const cpushader::FrameConstants& fc, int x0, int x1, int y0, int y1,
+                               uint8_t* rgba, int width) {
+    for (int row = y0; row < y1; row++) {
+        cpushader::shadeSpanScalar(fc, x0, x1, row, rgba + size_t(row) * width * 4);
+    }
+}
+
+void CpuRenderer::render(const FrameUniforms& uniforms, uint8_t* rgba) {
+    cpushader::FrameConstants fc;
+    cpushader::prepareFrame(uniforms, fc);
+
+    int width = static_cast<int>(uniforms.iResolution[0]);
+    int height = static_cast<int>(uniforms.iResolution[1]);
+    int tilesX = (width + CPU_TILE_WIDTH - 1) / CPU_TILE_WIDTH;
+    int tilesY = (height + CPU_TILE_HEIGHT - 1) / CPU_TILE_HEIGHT;
+    cpushader::ShadeRowsFunction shade = kernel;
+
+    pool.parallelFor(static_cast<uint32_t>(tilesX * tilesY), [&](uint32_t tile) {
+        int x0 = static_cast<int>(tile % tilesX) * CPU_TILE_WIDTH;
+        int y0 = static_cast<int>(tile / tilesX) * CPU_TILE_HEIGHT;
+        shade(fc, x0, std::min(x0 + CPU_TILE_WIDTH, width), y0, std::min(y0 + CPU_TILE_HEIGHT, height),
+              rgba, width);
+    });
+}
+
+int runCpuMode(const CpuModeOptions& options) {
+    uint32_t maxThreads = options.maxThreads ? options.maxThreads
+                                             : std::max(1u, std::thread::hardware_concurrency());
+
+    // 1, 2, 4, ... and always the requested maximum
+    std::vector<uint32_t> steps;
+    for (uint32_t t = 1; t < maxThreads; t *= 2) {
+        steps.push_back(t);
+    }
+    steps.push_back(maxThreads);
+
+    std::vector<uint8_t> image(size_t(options.width) * options.height * 4);
+    double baseFps = 0.0;
+
+    for (size_t i = 0; i < steps.size(); i++) {
+        CpuRenderer renderer(steps[i], options.allowSIMD);
+        if (i == 0) {
+            std::cout << "CPU renderer: " << options.width << "x" << options.height << ", "
+                      << options.frames << " frames per run, "
+                      << (renderer.usingAVX2() ? "AVX2 (8 pixels per lane)" : "scalar") << ", "
+                      << CPU_TILE_WIDTH << "x" << CPU_TILE_HEIGHT << " tiles" << std::endl
+                      << "threads    frames/s    Mpixel/s    speedup    efficiency    steals/frame" << std::endl;
+        }
+
+        // Same clock main() would produce at 60 Hz vsync, replayed identically for every run
+        uint32_t steals = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < options.frames; frame++) {
+            FrameUniforms uniforms;
+            uniforms.iResolution[0] = static_cast<float>(options.width);
+            uniforms.iResolution[1] = static_cast<float>(options.height);
+            uniforms.iTime = static_cast<float>(frame) / 60.0f;
+            uniforms.uRandom = options.uRandom;
+            uniforms.letters = &options.message;
+            FrameAnimation animation;
+            animateFrame(options.timeline, options.message, uniforms.iTime, animation);
+            uniforms.animation = &animation;
+            renderer.render(uniforms, image.data());
+            steals += renderer.lastStealCount();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double fps = options.frames / seconds;
+        if (i == 0) {
+            baseFps = fps;
+        }
+        double speedup = fps / baseFps;
+        char line[128];
+        snprintf(line, sizeof(line), "%7u  %10.2f  %10.2f  %8.2fx  %11.0f%%  %14.1f",
+                 steps[i], fps, fps * options.width * options.height / 1e6, speedup,
+                 100.0 * speedup / steps[i], double(steals) / options.frames);
+        std::cout << line << std::endl;
+    }
+
+    if (!options.outputPath.empty()) {
+        if (!writePPM(options.outputPath, image.data(), options.width, options.height)) {
+            std::cerr << "Failed to write image: " << options.outputPath << std::endl;
+            return 1;
+        }
+        std::cout << "Last frame written to " << options.outputPath << std::endl;
+    }
+    return 0;
+} // runCpuMode
@@ -0,0 +1,57 @@
+/*******************************************************************
+    Birthday Shader 2025 - multithreaded software renderer
+
+    Renders birthday.shader without any GPU or OpenGL context. The
+    frame is cut into tiles which are shaded on a work-stealing
+    thread pool, eight pixels per AVX2 lane where the CPU supports
+    it and one pixel at a time otherwise.
+*******************************************************************/
+#ifndef CPU_RENDERER_H
+#define CPU_RENDERER_H
+
+#include "cpu_shader.h"
+#include "thread_pool.h"
+
+#include <cstdint>
+#include <string>
+
+constexpr int CPU_TILE_WIDTH = 64;          // Multiple of the 8 AVX2 lanes
+constexpr int CPU_TILE_HEIGHT = 32;
+
+class CpuRenderer {
+public:
+    // threadCount 0 = one thread per hardware thread
+    explicit CpuRenderer(uint32_t threadCount, bool allowSIMD = true);
+
+    // Render one frame of iResolution[0] x iResolution[1] pixels into 'rgba'
+    // (4 bytes per pixel, top row first, like the image you see on screen)
+    void render(const FrameUniforms& uniforms, uint8_t* rgba);
+
+    uint32_t threadCount() const { return pool.size(); }
+    bool usingAVX2() const { return kernel != scalarKernel; }
+    uint32_t lastStealCount() const { return pool.lastStealCount(); }
+
+private:
+    static void scalarKernel(const cpushader::FrameConstants& fc, int x0, int x1, int y0, int y1,
+                             uint8_t* rgba, int width);
+
+    ThreadPool pool;
+    cpushader::ShadeRowsFunction kernel;
+};
+
+struct CpuModeOptions {
+    uint32_t width;
+    uint32_t height;
+    uint32_t frames;
+    uint32_t maxThreads;                    // 0 = all hardware threads
+    bool allowSIMD;
+    float uRandom;
+    LetterTable message;
+    Timeline timeline;
+    std::string outputPath;                 // Optional PPM of the last frame
+};
+
+// --cpu: render with 1, 2, 4 ... maxThreads threads and print how throughput scales
+int runCpuMode(const CpuModeOptions& options);
+
+#endif // CPU_RENDERER_H
@@ -0,0 +1,168 @@
+/*******************************************************************
+    Birthday Shader 2025 - AVX2 kernel for the CPU renderer
+
+    Runs the templated port in cpu_shader.h on eight horizontally
+    adjacent pixels at once. Only the handful of functions the shader
+    needs per pixel (sin/cos, sqrt, pow) get vector implementations;
+    the sin/cos and exp/log polynomials are the single precision
+    Cephes ones, which are well inside 8-bit output precision.
+
+    Build with -mavx2 on GCC/Clang (the Makefile does this on x86-64).
+    Without it, or on other CPUs, this file only provides a null
+    kernel and the renderer uses the scalar path.
+*******************************************************************/
+#include "cpu_shader.h"
+
+#if defined(__AVX2__) || (defined(_MSC_VER) && defined(_M_X64))
+
+#include <immintrin.h>
+
+namespace cpushader {
+
+struct F8 {
+    __m256 v;
+    F8() : v(_mm256_setzero_ps()) {}
+    F8(float f) : v(_mm256_set1_ps(f)) {}
+    F8(__m256 m) : v(m) {}
+};
+
+inline F8 operator+(F8 a, F8 b) { return _mm256_add_ps(a.v, b.v); }
+inline F8 operator-(F8 a, F8 b) { return _mm256_sub_ps(a.v, b.v); }
+inline F8 operator*(F8 a, F8 b) { return _mm256_mul_ps(a.v, b.v); }
+inline F8 operator/(F8 a, F8 b) { return _mm256_div_ps(a.v, b.v); }
+inline F8 operator-(F8 a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+
+inline F8 vmin(F8 a, F8 b) { return _mm256_min_ps(a.v, b.v); }
+inline F8 vmax(F8 a, F8 b) { return _mm256_max_ps(a.v, b.v); }
+inline F8 vabs(F8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+inline F8 vsqrt(F8 a) { return _mm256_sqrt_ps(a.v); }
+
+inline F8 vselectLess(F8 a, F8 b, F8 ifLess, F8 otherwise) {
+    return _mm256_blendv_ps(otherwise.v, ifLess.v, _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ));
+}
+
+// sin(x) for quadrantOffset 0, cos(x) for quadrantOffset 1
+inline F8 sinQuadrant(F8 x, int quadrantOffset) {
+    // Reduce to r in [-PI/4, PI/4] with x = j * PI/2 + r (Cody-Waite, three parts)
+    __m256 j = _mm256_round_ps(_mm256_mul_ps(x.v, _mm256_set1_ps(0.636619772f)),
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_sub_ps(x.v, _mm256_mul_ps(j, _mm256_set1_ps(1.5703125f)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(4.837512969970703125e-4f)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(7.54978995489188216e-8f)));
+    __m256i q = _mm256_add_epi32(_mm256_cvtps_epi32(j), _mm256_set1_epi32(quadrantOffset));
+
+    __m256 z = _mm256_mul_ps(r, r);
+    __m256 s = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-1.9515295891e-4f), z), _mm256_set1_ps(8.3321608736e-3f));
+    s = _mm256_add_ps(_mm256_mul_ps(s, z), _mm256_set1_ps(-1.6666654611e-1f));
+    s = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(s, z), r), r);
+    __m256 c = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(2.443315711809948e-5f), z), _mm256_set1_ps(-1.388731625493765e-3f));
+    c = _mm256_add_ps(_mm256_mul_ps(c, z), _mm256_set1_ps(4.166664568298827e-2f));
+    c = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(c, z), z), _mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(z, _mm256_set1_ps(0.5f))));
+
+    // Odd quadrants use the cosine polynomial, quadrants 2 and 3 flip the sign
+    __m256 useCos = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+    __m256 sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+    return _mm256_xor_ps(_mm256_blendv_ps(s, c, useCos), sign);
+}
+
+inline F8 vsin(F8 a) { return sinQuadrant(a, 0); }
+inline F8 vcos(F8 a) { return sinQuadrant(a, 1); }
+
+inline __m256 logApprox(__m256 x) {
+    // x = m * 2^e with m in [sqrt(.5), sqrt(2))
+    __m256i bits = _mm256_castps_si256(x);
+    __m256i e = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126));
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+                                                   _mm256_set1_epi32(0x3f000000)));
+    __m256 small = _mm256_cmp_ps(m, _mm256_set1_ps(0.707106781f), _CMP_LT_OQ);
+    __m256 ef = _mm256_sub_ps(_mm256_cvtepi32_ps(e), _mm256_and_ps(small, _mm256_set1_ps(1.0f)));
+    m = _mm256_sub_ps(_mm256_add_ps(m, _mm256_and_ps(small, m)), _mm256_set1_ps(1.0f));
+
+    __m256 z = _mm256_mul_ps(m, m);
+    __m256 y = _mm256_set1_ps(7.0376836292e-2f);
+    y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(-1.1514610310e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(1.1676998740e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(-1.2420140846e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(1.4249322787e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(-1.6668057665e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(2.0000714765e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(-2.4999993993e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(3.3333331174e-1f));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+    y = _mm256_sub_ps(y, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+    return _mm256_add_ps(_mm256_add_ps(m, y), _mm256_mul_ps(ef, _mm256_set1_ps(0.693147181f)));
+}
+
+inline __m256 expApprox(__m256 x) {
+    // x = n * ln(2) + r, exp(x) = 2^n * exp(r)
+    __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)),
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(0.693359375f)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(n, _mm256_set1_ps(-2.12194440e-4f)));
+
+    __m256 y = _mm256_set1_ps(1.9875691500e-4f);
+    y = _mm256_add_ps(_mm256_mul_ps(y, r), _mm256_set1_ps(1.3981999507e-3f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, r), _mm256_set1_ps(8.3334519073e-3f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, r), _mm256_set1_ps(4.1665795894e-2f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, r), _mm256_set1_ps(1.6666665459e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, r), _mm256_set1_ps(5.0000001201e-1f));
+    y = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(y, r), r), r), _mm256_set1_ps(1.0f));
+
+    __m256i scale = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(y, _mm256_castsi256_ps(scale));
+}
+
+// Only used for the final gamma with a non-negative base, so tiny bases can be floored
+inline F8 vpow(F8 a, float b) {
+    __m256 x = _mm256_max_ps(a.v, _mm256_set1_ps(1e-30f));
+    return expApprox(_mm256_mul_ps(logApprox(x), _mm256_set1_ps(b)));
+}
+
+namespace {
+
+void storeRGBA(const Color<F8>& c, uint8_t* dst) {
+    __m256 scale = _mm256_set1_ps(255.0f);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256i r = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(c.r.v, zero), one), scale));
+    __m256i g = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(c.g.v, zero), one), scale));
+    __m256i b = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(c.b.v, zero), one), scale));
+    __m256i rgba = _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                                   _mm256_or_si256(_mm256_slli_epi32(b, 16), _mm256_set1_epi32(int(0xff000000))));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), rgba);
+}
+
+void shadeRowsAVX2(const FrameConstants& fc, int x0, int x1, int y0, int y1, uint8_t* rgba, int width) {
+    const __m256 laneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+    for (int row = y0; row < y1; row++) {
+        uint8_t* rgbaRow = rgba + size_t(row) * width * 4;
+        F8 fragY(fc.resY - static_cast<float>(row) - 0.5f);
+        int x = x0;
+        for (; x + 8 <= x1; x += 8) {
+            F8 fragX = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffsets);
+            storeRGBA(shadePixel(fc, fragX, fragY), rgbaRow + 4 * x);
+        }
+        // Leftover pixels at the right edge of the image
+        shadeSpanScalar(fc, x, x1, row, rgbaRow);
+    }
+}
+
+} // namespace
+
+ShadeRowsFunction avx2Kernel() {
+    return shadeRowsAVX2;
+}
+
+} // namespace cpushader
+
+#else
+
+namespace cpushader {
+
+ShadeRowsFunction avx2Kernel() {
+    return nullptr;
+}
+
+} // namespace cpushader
+
+#endif
@@ -0,0 +1,380 @@
+/*******************************************************************
+    Birthday Shader 2025 - birthday.shader ported to C++
+
+    The fragment program is written once as a template over the lane
+    type V, so the same code runs one pixel at a time (V = float) or
+    eight pixels at a time (V = F8 in cpu_renderer_avx2.cpp). Every
+    value that is the same for the whole frame (letter offsets, the
+    letter wobble, the background noise lattice) is hoisted into
+    FrameConstants so only genuinely per-pixel math stays in the loop.
+
+    Keep this in step with birthday.shader when the shader changes.
+*******************************************************************/
+#ifndef CPU_SHADER_H
+#define CPU_SHADER_H
+
+#include "animation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+struct FrameUniforms {
+    float iResolution[2];
+    float iTime;
+    float uRandom;
+    const LetterTable* letters;             // The message, birthday.letters unless --message says otherwise
+    const FrameAnimation* animation;        // uScale and the letters' frames, from animateFrame()
+};
+
+namespace cpushader {
+
+constexpr float PI = 3.1415926535f;
+
+// Values that are constant across the frame, evaluated once per frame
+struct FrameConstants {
+    float resX, resY;
+    float invResX, invResY;
+    float ratio;
+    float uvScale;                          // uScale / iResolution.y
+
+    // drawBackground(): noise() lattice terms for uv.x*uv.y below [0] and above [1] zero
+    float noiseA0[2], noiseB0[2];
+    float noiseA1[2], noiseB1[2];
+    float wavePhase;                        // iTime * 2. reduced to [0, 2*PI)
+
+    float wobbleCos, wobbleSin;
+    const LetterTable* letters;
+    LetterOffset offsets[LETTER_MAX];
+};
+
+void prepareFrame(const FrameUniforms& uniforms, FrameConstants& fc);
+
+/***************************** Scalar lane math *****************************/
+
+inline float vmin(float a, float b) { return std::min(a, b); }
+inline float vmax(float a, float b) { return std::max(a, b); }
+inline float vabs(float a) { return std::fabs(a); }
+inline float vsqrt(float a) { return std::sqrt(a); }
+inline float vsin(float a) { return std::sin(a); }
+inline float vcos(float a) { return std::cos(a); }
+inline float vpow(float a, float b) { return std::pow(a, b); }
+inline float vselectLess(float a, float b, float ifLess, float otherwise) { return (a < b) ? ifLess : otherwise; }
+
+/***************************** GLSL helpers *****************************/
+
+template <typename V>
+struct Vec2 {
+    V x, y;
+};
+
+template <typename V>
+struct Color {
+    V r, g, b;
+};
+
+// GLSL 'p * rot(a)' with c = cos(a), s = sin(a)
+template <typename V, typename R>
+inline Vec2<V> rotate(const Vec2<V>& p, R c, R s) {
+    Vec2<V> result = { p.x * c - p.y * s, p.x * s + p.y * c };
+    return result;
+}
+
+template <typename V>
+inline Vec2<V> shift(const Vec2<V>& p, float dx, float dy) {
+    Vec2<V> result = { p.x + dx, p.y + dy };
+    return result;
+}
+
+template <typename V>
+inline V C(V x) {
+    return vmin(vmax(x, V(0.0f)), V(1.0f));
+}
+
+template <typename V>
+inline V S(float a, float b, V x) {
+    V t = C((x - a) * (1.0f / (b - a)));
+    return t * t * (3.0f - 2.0f * t);
+}
+
+template <typename V>
+inline void mixInto(Color<V>& col, const Color<V>& target, V amount) {
+    col.r = col.r + (target.r - col.r) * amount;
+    col.g = col.g + (target.g - col.g) * amount;
+    col.b = col.b + (target.b - col.b) * amount;
+}
+
+template <typename V>
+inline V sdBox(const Vec2<V>& p, float bx, float by) {
+    V dx = vabs(p.x) - bx;
+    V dy = vabs(p.y) - by;
+    V mx = vmax(dx, V(0.0f));
+    V my = vmax(dy, V(0.0f));
+    return vsqrt(mx * mx + my * my) + vmin(vmax(dx, dy), V(0.0f));
+}
+
+// Fixed stroke rotations used by the letter functions
+struct StrokeRotation {
+    float c, s;
+    explicit StrokeRotation(float a) : c(std::cos(a)), s(std::sin(a)) {}
+};
+
+const StrokeRotation ROT_A_LEFT(PI * .08f);
+const StrokeRotation ROT_A_RIGHT(-PI * .08f);
+const StrokeRotation ROT_R_LEG(-PI * .2f);
+const StrokeRotation ROT_Y_LEFT(PI * .86f);
+const StrokeRotation ROT_Y_RIGHT(-PI * .86f);
+const StrokeRotation ROT_BACKGROUND(-5.0f * PI / 180.0f);
+
+/***************************** Background *****************************/
+
+template <typename V>
+Color<V> drawBackground(const FrameConstants& fc, V fragX, V fragY) {
+    Vec2<V> uv = { fragX * fc.invResX - 0.5f, fragY * fc.invResY - 0.5f };
+
+    // noise() with the lattice rows picked by the sign of uv.x*uv.y (see prepareFrame)
+    V py = uv.x * uv.y;
+    V fy = vselectLess(py, V(0.0f), py + 1.0f, py);
+    V uy = fy * fy * (3.0f - 2.0f * fy);
+    V n0 = vselectLess(py, V(0.0f), V(fc.noiseA0[0]) + V(fc.noiseB0[0]) * fy,
+                                    V(fc.noiseA0[1]) + V(fc.noiseB0[1]) * fy);
+    V n1 = vselectLess(py, V(0.0f), V(fc.noiseA1[0]) + V(fc.noiseB1[0]) * (fy - 1.0f),
+                                    V(fc.noiseA1[1]) + V(fc.noiseB1[1]) * (fy - 1.0f));
+    V degree = 0.5f + 0.5f * (n0 + (n1 - n0) * uy);
+
+    uv.y = uv.y * (1.0f / fc.ratio);
+    V a = ((degree - .5f) * 720.0f + 180.0f) * (PI / 180.0f);
+    uv = rotate(uv, vcos(a), vsin(a));
+    uv.y = uv.y * fc.ratio;
+
+    // Wave warp with sin
+    uv.x = uv.x + vsin(uv.y * 5.0f + fc.wavePhase) * (1.0f / 30.0f);
+    uv.y = uv.y + vsin(uv.x * 7.5f + fc.wavePhase) * (1.0f / 15.0f);
+
+    V k = S(-.3f, .2f, uv.x * ROT_BACKGROUND.c - uv.y * ROT_BACKGROUND.s);
+    V m = S(.5f, -.3f, uv.y);
+
+    Color<V> layer1 = { .957f + (.192f - .957f) * k, .804f + (.384f - .804f) * k, .623f + (.933f - .623f) * k };
+    Color<V> layer2 = { .910f + (.350f - .910f) * k, .510f + (.71f - .510f) * k, .8f + (.953f - .8f) * k };
+    mixInto(layer1, layer2, m);
+    return layer1;
+}
+
+/***************************** Letters *****************************/
+
+// The letter functions take uv already rotated by the per-frame wobble
+template <typename V>
+V sdA(const Vec2<V>& uv, float ah, float al, float t, bool inner) {
+    V a = S(ah, al, sdBox(rotate(shift(uv, .1f, 0.0f), ROT_A_LEFT.c, ROT_A_LEFT.s), t, .25f + t));
+    a = a + S(ah, al, sdBox(rotate(shift(uv, -.1f, 0.0f), ROT_A_RIGHT.c, ROT_A_RIGHT.s), t, .25f + t));
+    a = a + S(ah, al, sdBox(shift(uv, 0.0f, .05f), .1f, t * .8f));
+    a = vmin(a, S(ah, al, sdBox(uv, .26f, .26f)));
+    if (inner)
+        a = vmin(a, S(ah, al, sdBox(uv, .26f, .25f)));
+    return a;
+}
+
+template <typename V>
+V sdB(const Vec2<V>& uv, float ah, float al, float t, float inner) {
+    V b = S(ah, al, sdBox(shift(uv, .12f, 0.0f), t, .2f + t));
+    b = b + S(ah, al, vabs(sdBox(shift(uv, t + inner, -.12f), .1f, .0001f) - .09f) - t * .9f);
+    b = b + S(ah, al, vabs(sdBox(shift(uv, t + inner, .12f), .1f, .0001f) - .09f) - t * .9f);
+    b = vmin(b, S(ah, al, sdBox(shift(uv, -.04f, 0.0f), .22f, .28f)));
+    if (inner > 0.0f)
+        b = vmin(b, S(ah, al, sdBox(shift(uv, -.0435f, 0.0f), .21f, .28f)));
+    return b;
+}
+
+template <typename V>
+V sdD(const Vec2<V>& uv, float ah, float al, float t, float inner) {
+    V d = S(ah, al, sdBox(shift(uv, .12f, 0.0f), t, .2f + t));
+    d = d + S(ah, al, vabs(sdBox(shift(uv, t + inner + .06f, 0.0f), .1f, .0001f) - .202f) - t);
+    d = vmin(d, S(ah, al, sdBox(shift(uv, -.04f, 0.0f), .22f, .28f)));
+    if (inner > 0.0f)
+        d = vmin(d, S(ah, al, sdBox(shift(uv, -.07f, 0.0f), .236f, .26f)));
+    return d;
+}
+
+template <typename V>
+V sdH(const Vec2<V>& uv, float ah, float al, float t) {
+    V h = S(ah, al, sdBox(shift(uv, .12f, 0.0f), t, .2f + t));
+    h = h + S(ah, al, sdBox(shift(uv, -.12f, 0.0f), t, .2f + t));
+    h = h + S(ah, al, sdBox(uv, .1f, t));
+    return h;
+}
+
+template <typename V>
+V sdI(const Vec2<V>& uv, float ah, float al, float t) {
+    return S(ah, al, sdBox(uv, t, .2f + t));
+}
+
+template <typename V>
+V sdP(const Vec2<V>& uv, float ah, float al, float t, float inner) {
+    V p = S(ah, al, sdBox(shift(uv, .12f, 0.0f), t, .2f + t));
+    p = p + S(ah, al, vabs(sdBox(shift(uv, t + inner, -.106f), .1f, .0001f) - .1f) - t);
+    p = vmin(p, S(ah, al, sdBox(shift(uv, -.04f, 0.0f), .22f, .28f)));
+    if (inner > 0.0f)
+        p = vmin(p, S(ah, al, sdBox(shift(uv, -.043f, 0.0f), .21f, .28f)));
+    return p;
+}
+
+template <typename V>
+V sdR(const Vec2<V>& uv, float ah, float al, float t, float inner) {
+    V r = S(ah, al, sdBox(shift(uv, .12f, 0.0f), t, .2f + t));
+    r = r + S(ah, al, vabs(sdBox(shift(uv, t + inner, -.106f), .1f, .0001f) - .1f) - t);
+    r = r + S(ah, al, sdBox(rotate(shift(uv, -.1f, .18f), ROT_R_LEG.c, ROT_R_LEG.s), t, .2f));
+    r = vmin(r, S(ah, al, sdBox(shift(uv, -.04f, -.02f), .22f, .28f)));
+    if (inner > 0.0f)
+        r = vmin(r, S(ah, al, sdBox(shift(uv, -.04f, -.02f - inner), .207f, .28f)));
+    return r;
+}
+
+template <typename V>
+V sdT(const Vec2<V>& uv, float ah, float al, float t, bool inner) {
+    V tt = S(ah, al, sdBox(shift(uv, 0.0f, .03f), t, .23f));
+    tt = tt + S(ah, al, sdBox(shift(uv, 0.0f, -.2f), .23f, t));
+    if (inner)
+        tt = vmin(tt, S(ah, al, sdBox(uv, .22f, .25f)));
+    return tt;
+}
+
+template <typename V>
+V sdY(const Vec2<V>& uv, float ah, float al, float t, bool inner) {
+    V y = S(ah, al, sdBox(shift(uv, 0.0f, .14f), t, .12f));
+    y = y + S(ah, al, sdBox(rotate(shift(uv, .1f, -.14f), ROT_Y_LEFT.c, ROT_Y_LEFT.s), t, .24f));
+    y = y + S(ah, al, sdBox(rotate(shift(uv, -.1f, -.14f), ROT_Y_RIGHT.c, ROT_Y_RIGHT.s), t, .24f));
+    y = vmin(y, S(ah, al, sdBox(shift(uv, 0.0f, .2f), .45f, .45f)));
+    if (inner)
+        y = vmin(y, S(ah, al, sdBox(shift(uv, 0.0f, .005f), .3f, .245f)));
+    return y;
+}
+
+/***************************** Main function *****************************/
+
+template <typename V>
+struct LetterFrame {
+    Vec2<V> st;                             // wobbled letter frame
+    V topGrad;
+    V botGrad;
+};
+
+// SETUP_LETTER plus the wobble every letter function starts with
+template <typename V>
+inline LetterFrame<V> setupLetter(const FrameConstants& fc, const Vec2<V>& uv, int index) {
+    Vec2<V> st = shift(uv, fc.offsets[index].x, fc.offsets[index].y);
+    V g = S(0.0f, 1.0f, C((3.0f * st.y - uv.y) * (3.0f * st.y - uv.y)));
+    LetterFrame<V> frame = { rotate(st, fc.wobbleCos, fc.wobbleSin), 1.3f - g, 0.7f + g };
+    return frame;
+}
+
+template <typename V>
+inline Color<V> letterColor(float r, float g, float b, V grad) {
+    Color<V> color = { 1.0f + (r - 1.0f) * grad, 1.0f + (g - 1.0f) * grad, 1.0f + (b - 1.0f) * grad };
+    return color;
+}
+
+// DRAW_GLYPH_x of birthday.shader: shadow, white outline, then the fill
+template <typename V>
+inline void drawGlyph(Color<V>& col, char glyph, const Vec2<V>& st, const Color<V>& fill) {
+    const Color<V> white = { 1.0f, 1.0f, 1.0f };
+    const Color<V> shadow = { 0.1f, 0.1f, 0.1f };
+    const float shadowStr = .666f;
+    switch (glyph) {
+    case 'A':
+        mixInto(col, shadow, shadowStr * sdA(st, .05f, -.05f, .05f, false));
+        mixInto(col, white, sdA(st, .015f, .005f, .055f, false));
+        mixInto(col, fill, sdA(st, .015f, .005f, .044f, true));
+        break;
+    case 'B':
+        mixInto(col, shadow, shadowStr * sdB(st, .06f, -.06f, .05f, 0.0f));
+        mixInto(col, white, sdB(st, .015f, .005f, .06f, 0.0f));
+        mixInto(col, fill, sdB(st, .015f, .005f, .046f, .01f));
+        break;
+    case 'D':
+        mixInto(col, shadow, shadowStr * sdD(st, .06f, -.06f, .05f, 0.0f));
+        mixInto(col, white, sdD(st, .015f, .005f, .06f, 0.0f));
+        mixInto(col, fill, sdD(st, .015f, .005f, .046f, .01f));
+        break;
+    case 'H':
+        mixInto(col, shadow, shadowStr * sdH(st, .06f, -.05f, .06f));
+        mixInto(col, white, sdH(st, .015f, .005f, .06f));
+        mixInto(col, fill, C(sdH(st, .015f, .005f, .048f)));
+        break;
+    case 'I':
+        mixInto(col, shadow, shadowStr * sdI(st, .06f, -.06f, .06f));
+        mixInto(col, white, sdI(st, .015f, .005f, .06f));
+        mixInto(col, fill, sdI(st, .015f, .005f, .048f));
+        break;
+    case 'P':
+        mixInto(col, shadow, shadowStr * sdP(st, .06f, -.06f, .05f, 0.0f));
+        mixInto(col, white, sdP(st, .015f, .005f, .06f, 0.0f));
+        mixInto(col, fill, sdP(st, .015f, .005f, .046f, .01f));
+        break;
+    case 'R':
+        mixInto(col, shadow, shadowStr * sdR(st, .06f, -.06f, .05f, .0f));
+        mixInto(col, white, sdR(st, .015f, .005f, .06f, .0f));
+        mixInto(col, fill, sdR(st, .015f, .005f, .046f, .01f));
+        break;
+    case 'T':
+        mixInto(col, shadow, shadowStr * sdT(st, .06f, -.06f, .06f, false));
+        mixInto(col, white, sdT(st, .015f, .005f, .06f, false));
+        mixInto(col, fill, C(sdT(st, .015f, .005f, .048f, true)));
+        break;
+    case 'Y':
+        mixInto(col, shadow, shadowStr * sdY(st, .05f, -.05f, .05f, false));
+        mixInto(col, white, sdY(st, .015f, .005f, .06f, false));
+        mixInto(col, fill, sdY(st, .015f, .005f, .048f, true));
+        break;
+    }
+} // drawGlyph
+
+template <typename V>
+Color<V> shadePixel(const FrameConstants& fc, V fragX, V fragY) {
+    // Fix coordinates for aspect ratio and scale
+    Vec2<V> uv = { (fragX + fragX - fc.resX) * fc.uvScale, (fragY + fragY - fc.resY) * fc.uvScale };
+
+    Color<V> col = drawBackground(fc, fragX, fragY);
+
+
+    for (size_t i = 0; i < fc.letters->letters.size(); i++) {
+        const LetterSpec& letter = fc.letters->letters[i];
+        LetterFrame<V> l = setupLetter(fc, uv, static_cast<int>(i));
+        drawGlyph(col, letter.glyph, l.st, letterColor(letter.color[0], letter.color[1], letter.color[2],
+                                                       letter.bottomRow ? l.botGrad : l.topGrad));
+    }
+
+    // pow() of a negative base is undefined in GLSL; drivers output black, so clamp first
+    Color<V> out = { vpow(vmax(col.r, V(0.0f)), .8f), vpow(vmax(col.g, V(0.0f)), .8f),
+                     vpow(vmax(col.b, V(0.0f)), .8f) };
+    return out;
+} // shadePixel
+
+// Convert a shaded value to an 8-bit UNORM channel the way GL does on write
+inline uint8_t toUnorm8(float v) {
+    v = std::min(std::max(v, 0.0f), 1.0f);
+    return static_cast<uint8_t>(v * 255.0f + 0.5f);
+}
+
+// Shade image rows [y0, y1) and columns [x0, x1) one pixel at a time.
+// The image is RGBA8 with row 0 at the top, i.e. fragCoord.y = height - row - 0.5
+inline void shadeSpanScalar(const FrameConstants& fc, int x0, int x1, int row, uint8_t* rgbaRow) {
+    float fragY = fc.resY - static_cast<float>(row) - 0.5f;
+    for (int x = x0; x < x1; x++) {
+        Color<float> c = shadePixel(fc, static_cast<float>(x) + 0.5f, fragY);
+        uint8_t* p = rgbaRow + 4 * x;
+        p[0] = toUnorm8(c.r);
+        p[1] = toUnorm8(c.g);
+        p[2] = toUnorm8(c.b);
+        p[3] = 255;
+    }
+}
+
+// Shades the rectangle [x0, x1) x [y0, y1) of an RGBA8 image that is 'width' pixels wide
+typedef void (*ShadeRowsFunction)(const FrameConstants& fc, int x0, int x1, int y0, int y1, uint8_t* rgba, int width);
+
+// Eight-lane kernel from cpu_renderer_avx2.cpp, or nullptr when this build has none
+ShadeRowsFunction avx2Kernel();
+
+} // namespace cpushader
+
+#endif // CPU_SHADER_H
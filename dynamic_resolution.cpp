@@ -0,0 +1,221 @@
+/*******************************************************************
+    Birthday Shader 2025 - dynamic resolution
+*******************************************************************/
+#include "dynamic_resolution.h"
+#include "animation.h"
+#include "gl_common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+constexpr float AVERAGE_WEIGHT = 0.1f;          // Of the newest sample in the moving average
+constexpr float DOWN_THRESHOLD = 1.0f;          // Drop when the average is over budget...
+constexpr uint32_t DOWN_SETTLE_FRAMES = 8;      // ...and the last change has had time to show up
+constexpr float DOWN_TARGET = 0.9f;             // Aim a little under budget so it doesn't bounce
+constexpr float UP_THRESHOLD = 0.7f;            // Raise one step when comfortably under budget...
+constexpr uint32_t UP_SETTLE_FRAMES = 60;       // ...for about a second
+constexpr uint32_t WARMUP_SAMPLES = 4;          // Ignored after a reset: shader JIT and first-use costs
+constexpr float SAMPLE_LIMIT = 4.0f;            // One hitch counts as at most this many budgets
+
+const char* upscaleVertexSource = R"(
+    #version 330 core
+    layout (location = 0) in vec2 aPos;
+    out vec2 uv;
+    uniform vec2 uvScale;
+
+    void main() {
+        gl_Position = vec4(aPos, 0.0, 1.0);
+        uv = (aPos * 0.5 + 0.5) * uvScale;
+    }
+)";
+
+// Bilinear, clamped half a texel inside the rendered corner so nothing bleeds in from beyond it
+const char* upscaleFragmentSource = R"(
+    #version 330 core
+    in vec2 uv;
+    out vec4 O;
+    uniform sampler2D scene;
+    uniform vec2 uvMax;
+
+    void main() {
+        O = texture(scene, min(uv, uvMax));
+    }
+)";
+
+float quantizeScale(float scale) {
+    float steps = std::floor(scale / DYNAMIC_RES_STEP + 0.001f);
+    return clamp(steps * DYNAMIC_RES_STEP, DYNAMIC_RES_MIN_SCALE, 1.0f);
+}
+
+} // namespace
+
+/***************************** ResolutionController *****************************/
+
+ResolutionController::ResolutionController(float budgetMilliseconds) : budget(budgetMilliseconds) {
+}
+
+void ResolutionController::reset() {
+    currentScale = 1.0f;
+    averageMilliseconds = 0.0f;
+    framesSinceChange = 0;
+    samplesSkipped = 0;
+    decision.clear();
+}
+
+bool ResolutionController::update(float gpuMilliseconds) {
+    if (samplesSkipped < WARMUP_SAMPLES) {
+        samplesSkipped++;
+        return false;
+    }
+    gpuMilliseconds = std::min(gpuMilliseconds, budget * SAMPLE_LIMIT);
+    averageMilliseconds = (averageMilliseconds == 0.0f) ? gpuMilliseconds
+        : averageMilliseconds + AVERAGE_WEIGHT * (gpuMilliseconds - averageMilliseconds);
+    framesSinceChange++;
+
+    float newScale = currentScale;
+    if ((averageMilliseconds > budget * DOWN_THRESHOLD) && (framesSinceChange >= DOWN_SETTLE_FRAMES)) {
+        // Cost goes with the pixel count, the square of the scale
+        newScale = quantizeScale(currentScale * std::sqrt(budget * DOWN_TARGET / averageMilliseconds));
+    } else if ((averageMilliseconds < budget * UP_THRESHOLD) && (framesSinceChange >= UP_SETTLE_FRAMES)) {
+        newScale = quantizeScale(currentScale + DYNAMIC_RES_STEP);
+    }
+    if (newScale == currentScale) {
+        return false;
+    }
+
+    char text[96];
+    snprintf(text, sizeof(text), "%s %d%% -> %d%% at %.1f ms", (newScale < currentScale) ? "down" : "up",
+             static_cast<int>(currentScale * 100.0f + 0.5f), static_cast<int>(newScale * 100.0f + 0.5f),
+             averageMilliseconds);
+    decision = text;
+
+    // Predict the new cost so the average doesn't have to unlearn the old one
+    averageMilliseconds *= (newScale * newScale) / (currentScale * currentScale);
+    currentScale = newScale;
+    framesSinceChange = 0;
+    return true;
+}
+
+/***************************** DynamicResolution *****************************/
+
+DynamicResolution::~DynamicResolution() {
+    destroy();
+}
+
+void DynamicResolution::destroy() {
+    if (upscaleProgram) {
+        glDeleteProgram(upscaleProgram);
+        glDeleteQueries(DYNAMIC_RES_QUERY_COUNT, queries);
+        upscaleProgram = 0;
+    }
+    target.destroy();
+}
+
+bool DynamicResolution::create(uint32_t width, uint32_t height, float budgetMilliseconds) {
+    control = ResolutionController(budgetMilliseconds);
+
+    GLint sceneProgram = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &sceneProgram);
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, upscaleVertexSource);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, upscaleFragmentSource);
+    upscaleProgram = linkProgram(vertexShader, fragmentShader);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    uvScaleLocation = glGetUniformLocation(upscaleProgram, "uvScale");
+    uvMaxLocation = glGetUniformLocation(upscaleProgram, "uvMax");
+    glUseProgram(upscaleProgram);
+    glUniform1i(glGetUniformLocation(upscaleProgram, "scene"), 0);
+    glUseProgram(sceneProgram);
+
+    glGenQueries(DYNAMIC_RES_QUERY_COUNT, queries);
+    resize(width, height);
+    return target.framebuffer != 0;
+}
+
+void DynamicResolution::resize(uint32_t width, uint32_t height) {
+    if ((width == outputWidth) && (height == outputHeight)) {
+        return;
+    }
+    outputWidth = width;
+    outputHeight = height;
+    target.create(width, height);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void DynamicResolution::setEnabled(bool enable) {
+    active = enable;
+    control.reset();
+}
+
+void DynamicResolution::beginFrame(uint32_t& width, uint32_t& height) {
+    collectTimings();
+
+    float scale = active ? control.scale() : 1.0f;
+    upscaling = (scale < 1.0f);
+    renderWidth = upscaling ? std::max(1u, static_cast<uint32_t>(outputWidth * scale + 0.5f)) : outputWidth;
+    renderHeight = upscaling ? std::max(1u, static_cast<uint32_t>(outputHeight * scale + 0.5f)) : outputHeight;
+    width = renderWidth;
+    height = renderHeight;
+
+    // Time the whole frame, upscale included, when a query is free; otherwise this frame goes unmeasured
+    timing = (queriesIssued - queriesCollected < DYNAMIC_RES_QUERY_COUNT);
+    if (timing) {
+        glBeginQuery(GL_TIME_ELAPSED, queries[queriesIssued % DYNAMIC_RES_QUERY_COUNT]);
+        queriesIssued++;
+    }
+
+    if (upscaling) {
+        glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+    }
+    glViewport(0, 0, renderWidth, renderHeight);
+}
+
+void DynamicResolution::endFrame(GLuint outputFramebuffer) {
+    if (upscaling) {
+        glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+        glViewport(0, 0, outputWidth, outputHeight);
+        glUseProgram(upscaleProgram);
+        glUniform2f(uvScaleLocation, float(renderWidth) / outputWidth, float(renderHeight) / outputHeight);
+        glUniform2f(uvMaxLocation, (renderWidth - 0.5f) / outputWidth, (renderHeight - 0.5f) / outputHeight);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, target.colorTexture);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+
+    if (timing) {
+        glEndQuery(GL_TIME_ELAPSED);
+    }
+}
+
+void DynamicResolution::collectTimings() {
+    // Only results that are already there; never wait on the GPU
+    while (queriesCollected != queriesIssued) {
+        GLuint query = queries[queriesCollected % DYNAMIC_RES_QUERY_COUNT];
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+        queriesCollected++;
+        if (active) {
+            control.update(static_cast<float>(elapsed / 1.0e6));
+        }
+    }
+}
+
+std::string DynamicResolution::status() const {
+    char text[160];
+    if (!active) {
+        snprintf(text, sizeof(text), "dynamic resolution off");
+        return text;
+    }
+    snprintf(text, sizeof(text), "%d%% %ux%u, GPU %.1f / %.1f ms%s%s", static_cast<int>(control.scale() * 100.0f + 0.5f),
+             renderWidth, renderHeight, control.smoothedMilliseconds(), control.budgetMilliseconds(),
+             control.lastDecision().empty() ? "" : ", ", control.lastDecision().c_str());
+    return text;
+}
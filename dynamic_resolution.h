@@ -0,0 +1,101 @@
+/*******************************************************************
+    Birthday Shader 2025 - dynamic resolution
+
+    Renders the shader into an offscreen target at a fraction of the
+    window's size and stretches it back up with a bilinear pass, so a
+    big window on a slow GPU still makes vsync. The fraction comes from
+    a controller that watches GPU frame time (GL_TIME_ELAPSED, read back
+    a few frames late so nothing waits) against a budget: it drops the
+    scale quickly when frames run long and creeps back up once there is
+    headroom. At full scale the shader draws straight to the window.
+*******************************************************************/
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include "headless.h"
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+
+constexpr float DYNAMIC_RES_DEFAULT_BUDGET_MS = 15.0f;  // Leaves some of a 60 Hz frame for everything else
+constexpr float DYNAMIC_RES_MIN_SCALE = 0.25f;
+constexpr float DYNAMIC_RES_STEP = 0.05f;               // Scales are multiples of this
+constexpr uint32_t DYNAMIC_RES_QUERY_COUNT = 4;
+
+// Decides the resolution scale from measured GPU frame times
+class ResolutionController {
+public:
+    explicit ResolutionController(float budgetMilliseconds = DYNAMIC_RES_DEFAULT_BUDGET_MS);
+
+    // Feed one frame's GPU time; returns true when the scale changed
+    bool update(float gpuMilliseconds);
+    void reset();
+
+    float scale() const { return currentScale; }
+    float smoothedMilliseconds() const { return averageMilliseconds; }
+    float budgetMilliseconds() const { return budget; }
+    const std::string& lastDecision() const { return decision; }
+
+private:
+    float budget;
+    float currentScale = 1.0f;
+    float averageMilliseconds = 0.0f;       // Exponential moving average, 0 until the first sample
+    uint32_t framesSinceChange = 0;
+    uint32_t samplesSkipped = 0;
+    std::string decision;
+};
+
+class DynamicResolution {
+public:
+    DynamicResolution() = default;
+    ~DynamicResolution();
+
+    DynamicResolution(const DynamicResolution&) = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+    // Needs a current context. width/height are the output (window framebuffer) size
+    bool create(uint32_t width, uint32_t height, float budgetMilliseconds);
+    void destroy();                         // Before the context goes away
+    void resize(uint32_t width, uint32_t height);
+    void setEnabled(bool enable);
+    bool enabled() const { return active; }
+
+    // Bind the target for this frame's scene draw and return the size to give iResolution.
+    // At full scale the output framebuffer, bound by the caller, is left in place
+    void beginFrame(uint32_t& renderWidth, uint32_t& renderHeight);
+
+    // Stretch the scene into outputFramebuffer (0 = the window) using the bound full-screen quad and
+    // pick up any finished GPU timings. When upscaling, the upscale program is left in use; Scene::draw()
+    // puts its own back
+    void endFrame(GLuint outputFramebuffer = 0);
+
+    const ResolutionController& controller() const { return control; }
+    void outputSize(uint32_t& width, uint32_t& height) const { width = outputWidth; height = outputHeight; }
+
+    // "75% 1440x810, GPU 12.3 / 15.0 ms, down 85% -> 75%" for the FPS display
+    std::string status() const;
+
+private:
+    void collectTimings();
+
+    ResolutionController control;
+    bool active = true;
+    OffscreenTarget target;                 // Allocated at the output size, drawn into a corner of it
+    uint32_t outputWidth = 0;
+    uint32_t outputHeight = 0;
+    uint32_t renderWidth = 0;
+    uint32_t renderHeight = 0;
+    bool upscaling = false;                 // This frame went through the offscreen target
+
+    GLuint upscaleProgram = 0;
+    int uvScaleLocation = -1;
+    int uvMaxLocation = -1;
+
+    GLuint queries[DYNAMIC_RES_QUERY_COUNT] = {};
+    uint32_t queriesIssued = 0;
+    uint32_t queriesCollected = 0;
+    bool timing = false;                    // A query is open for this frame
+};
+
+#endif // DYNAMIC_RESOLUTION_H
@@ -0,0 +1,85 @@
+/*******************************************************************
+    Birthday Shader 2025 - build step that bakes data files into the binary
+
+        embed_files OUTPUT FILE...
+
+    Writes OUTPUT, a header with each FILE as a constexpr string under
+    the name it was given by, read with its #include lines expanded
+    (shader_include.h). Run by the Makefile and winmakecpp.bat before
+    embedded_files.cpp is compiled; see embedded_files.h.
+*******************************************************************/
+#include "shader_include.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+// One C++ string literal per line of text, so the generated header stays readable
+void writeLiteral(std::ostream& out, const std::string& text) {
+    out << "        \"";
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '\n') {
+            out << "\\n\"";
+            if (i + 1 < text.size()) {
+                out << "\n        \"";
+            }
+            continue;
+        }
+        if ((c == '"') || (c == '\\')) {
+            out << '\\' << c;
+        } else if (c == '?') {
+            out << "\\?";                   // No accidental trigraphs
+        } else if (c == '\t') {
+            out << "\\t";
+        } else if ((c < 0x20) || (c >= 0x7f)) {
+            char escape[8];
+            snprintf(escape, sizeof(escape), "\\%03o", c);
+            out << escape;
+        } else {
+            out << c;
+        }
+    }
+    if (text.empty() || (text.back() != '\n')) {
+        out << "\"";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " OUTPUT FILE..." << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(argv[1]);
+    if (!out) {
+        std::cerr << "Failed to create " << argv[1] << std::endl;
+        return 1;
+    }
+    out << "// Generated by embed_files from";
+    for (int i = 2; i < argc; i++) {
+        out << " " << argv[i];
+    }
+    out << "; do not edit" << std::endl << std::endl;
+    out << "constexpr EmbeddedFile embeddedFiles[] = {" << std::endl;
+
+    for (int i = 2; i < argc; i++) {
+        std::string text, error;
+        if (!readShaderIncludes(argv[i], text, error)) {
+            std::cerr << error << std::endl;
+            out.close();
+            remove(argv[1]);                // Don't leave a half-written header for make to trust
+            return 1;
+        }
+        out << "    { \"" << argv[i] << "\"," << std::endl;
+        writeLiteral(out, text);
+        out << " }," << std::endl;
+    }
+    out << "};" << std::endl;
+    return out.good() ? 0 : 1;
+} // main
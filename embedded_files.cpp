@@ -0,0 +1,16 @@
+/*******************************************************************
+    Birthday Shader 2025 - data files built into the binary
+*******************************************************************/
+#include "embedded_files.h"
+
+#include "embedded_data.h"                  // Generated by embed_files
+
+bool embeddedFile(const std::string& name, std::string& contents) {
+    for (const EmbeddedFile& file : embeddedFiles) {
+        if (name == file.name) {
+            contents = file.contents;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,23 @@
+/*******************************************************************
+    Birthday Shader 2025 - data files built into the binary
+
+    birthday.shader (with everything it includes), birthday.letters and
+    birthday.timeline are baked in at build time by embed_files, so the
+    program runs from any working directory without opening a file.
+    --shader, --message and --timeline still read from disk, which is
+    how they get edited: only a shader loaded that way hot-reloads.
+*******************************************************************/
+#ifndef EMBEDDED_FILES_H
+#define EMBEDDED_FILES_H
+
+#include <string>
+
+struct EmbeddedFile {
+    const char* name;                       // As given to embed_files, e.g. "birthday.shader"
+    const char* contents;
+};
+
+// False when nothing was built in under that name
+bool embeddedFile(const std::string& name, std::string& contents);
+
+#endif // EMBEDDED_FILES_H
@@ -0,0 +1,317 @@
+/*******************************************************************
+    Birthday Shader 2025 - streaming frame export
+*******************************************************************/
+#include "frame_export.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+
+double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+bool parseExportFormat(const char* name, ExportFormat& format) {
+    if (strcmp(name, "y4m") == 0) {
+        format = EXPORT_Y4M;
+    } else if (strcmp(name, "rgba") == 0) {
+        format = EXPORT_RGBA;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void FrameExporter::StageTime::add(double seconds) {
+    total += seconds;
+    worst = std::max(worst, seconds);
+    if (seconds > 0.001) {
+        stalls++;
+    }
+}
+
+FrameExporter::~FrameExporter() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            closing = true;
+        }
+        queueCondition.notify_all();
+        writer.join();
+    }
+    if (output && (output != stdout)) {
+        fclose(output);
+    }
+}
+
+bool FrameExporter::open(const std::string& path, ExportFormat exportFormat, uint32_t w, uint32_t h, float fps) {
+    format = exportFormat;
+    width = w;
+    height = h;
+
+    if (path == "-") {
+#if defined(_WIN32)
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        output = stdout;
+    } else {
+        output = fopen(path.c_str(), "wb");
+        if (!output) {
+            return false;
+        }
+    }
+
+    if (format == EXPORT_Y4M) {
+        // Frame rate as a fraction so 29.97 and friends survive
+        uint32_t rateNumerator = static_cast<uint32_t>(fps * 1000.0f + 0.5f);
+        uint32_t rateDenominator = 1000;
+        while ((rateNumerator % 10 == 0) && (rateDenominator % 10 == 0)) {
+            rateNumerator /= 10;
+            rateDenominator /= 10;
+        }
+        fprintf(output, "YUV4MPEG2 W%u H%u F%u:%u Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n",
+                width, height, rateNumerator, rateDenominator);
+    }
+
+    size_t frameBytes = size_t(width) * height * 4;
+    for (PixelSlot& slot : slots) {
+        glGenBuffers(1, &slot.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    buffers.resize(EXPORT_QUEUE_FRAMES);
+    for (uint32_t i = 0; i < EXPORT_QUEUE_FRAMES; i++) {
+        buffers[i].resize(frameBytes);
+        freeBuffers.push_back(i);
+    }
+
+    writer = std::thread(&FrameExporter::writerLoop, this);
+    return true;
+}
+
+void FrameExporter::capture() {
+    if (framesCaptured == 0) {
+        firstCapture = now();
+    }
+
+    // Hand over whatever the GPU has already finished without waiting for it
+    while ((slotsInFlight > 0) && pollOldest()) {
+        retireOldest();
+    }
+    if (slotsInFlight == EXPORT_PBO_COUNT) {
+        // Every PBO is still in flight: wait for the oldest one, this is the only GPU stall
+        PixelSlot& oldest = slots[oldestSlot];
+        double start = now();
+        while (glClientWaitSync(oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000) == GL_TIMEOUT_EXPIRED) {
+        }
+        readbackWait.add(now() - start);
+        retireOldest();
+    }
+
+    PixelSlot& slot = slots[(oldestSlot + slotsInFlight) % EXPORT_PBO_COUNT];
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slotsInFlight++;
+    framesCaptured++;
+}
+
+bool FrameExporter::pollOldest() {
+    GLenum status = glClientWaitSync(slots[oldestSlot].fence, 0, 0);
+    return (status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED);
+}
+
+void FrameExporter::retireOldest() {
+    PixelSlot& slot = slots[oldestSlot];
+    uint32_t buffer = acquireBuffer();
+
+    double start = now();
+    size_t frameBytes = size_t(width) * height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameBytes, GL_MAP_READ_BIT);
+    if (pixels) {
+        memcpy(buffers[buffer].data(), pixels, frameBytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    copyTime.add(now() - start);
+
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    oldestSlot = (oldestSlot + 1) % EXPORT_PBO_COUNT;
+    slotsInFlight--;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queuedBuffers.push_back(buffer);
+    }
+    queueCondition.notify_all();
+}
+
+uint32_t FrameExporter::acquireBuffer() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    if (freeBuffers.empty()) {
+        // The writer is EXPORT_QUEUE_FRAMES behind; memory stays bounded, so wait for it
+        double start = now();
+        queueCondition.wait(lock, [this] { return !freeBuffers.empty(); });
+        queueWait.add(now() - start);
+    }
+    uint32_t buffer = freeBuffers.front();
+    freeBuffers.pop_front();
+    return buffer;
+}
+
+void FrameExporter::writerLoop() {
+    std::vector<uint8_t> converted;
+    while (true) {
+        uint32_t buffer = 0;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] { return closing || !queuedBuffers.empty(); });
+            if (queuedBuffers.empty()) {
+                return;
+            }
+            buffer = queuedBuffers.front();
+            queuedBuffers.pop_front();
+        }
+
+        if (!writeFailed) {
+            double start = now();
+            if (format == EXPORT_Y4M) {
+                convertY4M(buffers[buffer].data(), converted);
+            } else {
+                convertRGBA(buffers[buffer].data(), converted);
+            }
+            double convertedAt = now();
+            convertTime.add(convertedAt - start);
+
+            if (fwrite(converted.data(), 1, converted.size(), output) != converted.size()) {
+                writeFailed = true;
+            } else {
+                framesWritten++;
+            }
+            ioTime.add(now() - convertedAt);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            freeBuffers.push_back(buffer);
+        }
+        queueCondition.notify_all();
+    }
+}
+
+// glReadPixels rows are bottom-up; both formats are written top row first
+void FrameExporter::convertY4M(const uint8_t* rgba, std::vector<uint8_t>& out) const {
+    static const char frameHeader[] = "FRAME\n";
+    size_t headerBytes = sizeof(frameHeader) - 1;
+    uint32_t chromaWidth = (width + 1) / 2;
+    uint32_t chromaHeight = (height + 1) / 2;
+    size_t lumaBytes = size_t(width) * height;
+    size_t chromaBytes = size_t(chromaWidth) * chromaHeight;
+    out.resize(headerBytes + lumaBytes + 2 * chromaBytes);
+    memcpy(out.data(), frameHeader, headerBytes);
+    uint8_t* yPlane = out.data() + headerBytes;
+    uint8_t* uPlane = yPlane + lumaBytes;
+    uint8_t* vPlane = uPlane + chromaBytes;
+
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* src = rgba + size_t(height - 1 - y) * width * 4;
+        uint8_t* dst = yPlane + size_t(y) * width;
+        for (uint32_t x = 0; x < width; x++) {
+            int r = src[x * 4 + 0], g = src[x * 4 + 1], b = src[x * 4 + 2];
+            dst[x] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        }
+    }
+
+    // Chroma from the average of each 2x2 block (edge pixels repeat on odd sizes)
+    for (uint32_t cy = 0; cy < chromaHeight; cy++) {
+        uint32_t y0 = cy * 2;
+        uint32_t y1 = std::min(y0 + 1, height - 1);
+        const uint8_t* row0 = rgba + size_t(height - 1 - y0) * width * 4;
+        const uint8_t* row1 = rgba + size_t(height - 1 - y1) * width * 4;
+        for (uint32_t cx = 0; cx < chromaWidth; cx++) {
+            uint32_t x0 = cx * 2 * 4;
+            uint32_t x1 = std::min(cx * 2 + 1, width - 1) * 4;
+            int r = (row0[x0] + row0[x1] + row1[x0] + row1[x1] + 2) >> 2;
+            int g = (row0[x0 + 1] + row0[x1 + 1] + row1[x0 + 1] + row1[x1 + 1] + 2) >> 2;
+            int b = (row0[x0 + 2] + row0[x1 + 2] + row1[x0 + 2] + row1[x1 + 2] + 2) >> 2;
+            uPlane[cy * chromaWidth + cx] = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            vPlane[cy * chromaWidth + cx] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}
+
+void FrameExporter::convertRGBA(const uint8_t* rgba, std::vector<uint8_t>& out) const {
+    size_t rowBytes = size_t(width) * 4;
+    out.resize(rowBytes * height);
+    for (uint32_t y = 0; y < height; y++) {
+        memcpy(out.data() + y * rowBytes, rgba + size_t(height - 1 - y) * rowBytes, rowBytes);
+    }
+}
+
+bool FrameExporter::finish(std::ostream& report) {
+    if (!writer.joinable()) {
+        return false;
+    }
+
+    while (slotsInFlight > 0) {
+        PixelSlot& oldest = slots[oldestSlot];
+        while (glClientWaitSync(oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000) == GL_TIMEOUT_EXPIRED) {
+        }
+        retireOldest();
+    }
+    double renderSeconds = now() - firstCapture;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        closing = true;
+    }
+    queueCondition.notify_all();
+    writer.join();
+    fflush(output);
+    double totalSeconds = now() - firstCapture;
+
+    for (PixelSlot& slot : slots) {
+        glDeleteBuffers(1, &slot.pbo);
+        slot.pbo = 0;
+    }
+
+    char line[160];
+    report << "Exported " << framesWritten << " of " << framesCaptured << " frames ("
+           << ((format == EXPORT_Y4M) ? "y4m" : "rgba") << ", " << width << "x" << height << ")" << std::endl;
+    snprintf(line, sizeof(line), "  render loop %.2f frames/s, including writer drain %.2f frames/s",
+             ((framesCaptured > 0) && (renderSeconds > 0.0)) ? framesCaptured / renderSeconds : 0.0,
+             ((framesCaptured > 0) && (totalSeconds > 0.0)) ? framesWritten / totalSeconds : 0.0);
+    report << line << std::endl;
+    report << "  stage               total ms   worst ms   stalls >1ms" << std::endl;
+    const struct { const char* name; const StageTime* time; } stages[] = {
+        { "readback fence", &readbackWait },
+        { "PBO map + copy", &copyTime },
+        { "writer queue full", &queueWait },
+        { "convert (writer)", &convertTime },
+        { "I/O (writer)", &ioTime },
+    };
+    for (const auto& stage : stages) {
+        snprintf(line, sizeof(line), "  %-18s %9.1f  %9.2f  %12u", stage.name, stage.time->total * 1000.0,
+                 stage.time->worst * 1000.0, stage.time->stalls);
+        report << line << std::endl;
+    }
+    if (writeFailed) {
+        report << "  write error: the output was closed or the disk is full" << std::endl;
+    }
+    return !writeFailed;
+} // finish
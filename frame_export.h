@@ -0,0 +1,109 @@
+/*******************************************************************
+    Birthday Shader 2025 - streaming frame export
+
+    Streams rendered frames to a file or stdout as YUV4MPEG2 (ready
+    to pipe into an encoder) or as raw top-down RGBA. Readback goes
+    through a ring of pixel buffer objects guarded by fences, so the
+    GPU is never waited on for the frame that was just drawn, and a
+    writer thread does the colour conversion and all of the I/O so
+    the render loop never waits on the disk or the pipe.
+*******************************************************************/
+#ifndef FRAME_EXPORT_H
+#define FRAME_EXPORT_H
+
+#include <GL/glew.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr uint32_t EXPORT_PBO_COUNT = 3;        // Frames in flight between draw and readback
+constexpr uint32_t EXPORT_QUEUE_FRAMES = 8;     // Frames buffered for the writer thread
+
+enum ExportFormat {
+    EXPORT_NONE,
+    EXPORT_Y4M,                             // YUV4MPEG2, 4:2:0, BT.601 limited range
+    EXPORT_RGBA                             // Raw 8-bit RGBA, top row first, no header
+};
+
+bool parseExportFormat(const char* name, ExportFormat& format);
+
+class FrameExporter {
+public:
+    FrameExporter() = default;
+    ~FrameExporter();
+
+    FrameExporter(const FrameExporter&) = delete;
+    FrameExporter& operator=(const FrameExporter&) = delete;
+
+    // path "-" streams to stdout. Needs a current GL context; fps only goes into the Y4M header
+    bool open(const std::string& path, ExportFormat format, uint32_t width, uint32_t height, float fps);
+
+    // Queue a readback of the currently bound read framebuffer; call right after drawing the frame
+    void capture();
+
+    // Drain every frame in flight, stop the writer and print throughput and stall times
+    bool finish(std::ostream& report);
+
+    bool writingToStdout() const { return output == stdout; }
+
+private:
+    struct PixelSlot {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+    };
+
+    // Time spent in one stage, in seconds
+    struct StageTime {
+        double total = 0.0;
+        double worst = 0.0;
+        uint32_t stalls = 0;                // Waits longer than a millisecond
+        void add(double seconds);
+    };
+
+    bool pollOldest();
+    void retireOldest();
+    uint32_t acquireBuffer();
+    void writerLoop();
+    void convertY4M(const uint8_t* rgba, std::vector<uint8_t>& out) const;
+    void convertRGBA(const uint8_t* rgba, std::vector<uint8_t>& out) const;
+
+    ExportFormat format = EXPORT_NONE;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    FILE* output = nullptr;
+
+    PixelSlot slots[EXPORT_PBO_COUNT];
+    uint32_t oldestSlot = 0;
+    uint32_t slotsInFlight = 0;
+
+    // CPU copies handed from the render thread to the writer thread
+    std::vector<std::vector<uint8_t>> buffers;
+    std::deque<uint32_t> freeBuffers;
+    std::deque<uint32_t> queuedBuffers;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    bool closing = false;
+    bool writeFailed = false;
+    std::thread writer;
+
+    // Render thread
+    uint32_t framesCaptured = 0;
+    StageTime readbackWait;                 // Blocked on a fence because every PBO was still in flight
+    StageTime copyTime;                     // Mapping a PBO and copying it out
+    StageTime queueWait;                    // Blocked because the writer thread had fallen behind
+    double firstCapture = 0.0;
+
+    // Writer thread
+    uint32_t framesWritten = 0;
+    StageTime convertTime;
+    StageTime ioTime;
+};
+
+#endif // FRAME_EXPORT_H
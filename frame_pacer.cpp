@@ -0,0 +1,139 @@
+/*******************************************************************
+    Birthday Shader 2025 - frame pacing
+*******************************************************************/
+#include "frame_pacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+namespace {
+
+const double binLimits[PACER_HISTOGRAM_BINS - 1] = {0.1, 0.25, 0.5, 1.0, 2.0, 4.0, 8.0};
+
+} // namespace
+
+void FramePacer::configure(double limitFps, double idleFps, double refreshRate) {
+    limit = std::max(limitFps, 0.0);
+    idleRate = (idleFps > 0.0) ? idleFps : PACER_DEFAULT_IDLE_FPS;
+    refresh = std::max(refreshRate, 0.0);
+    restart();
+}
+
+void FramePacer::setVsync(bool on) {
+    if (vsync != on) {
+        vsync = on;
+        restart();
+    }
+}
+
+void FramePacer::setFocused(bool on) {
+    if (focused != on) {
+        focused = on;
+        restart();
+    }
+}
+
+void FramePacer::setIconified(bool on) {
+    if (iconified != on) {
+        iconified = on;
+        restart();
+    }
+}
+
+double FramePacer::targetPeriod() const {
+    if (idle()) {
+        return 0.0;                         // Nobody is looking; not worth measuring
+    }
+    if (!vsync) {
+        return (limit > 0.0) ? 1.0 / limit : 0.0;
+    }
+    return (refresh > 0.0) ? 1.0 / refresh : 0.0;
+}
+
+void FramePacer::restart() {
+    haveDeadline = false;
+    havePresent = false;
+}
+
+void FramePacer::wait() {
+    if (!pacing()) {
+        return;
+    }
+    double rate = idle() ? idleRate : limit;
+    auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+
+    auto now = Clock::now();
+    if (!haveDeadline || (now - deadline > period)) {
+        // First paced frame, or this one took longer than a whole period: don't try to catch up
+        deadline = now;
+        haveDeadline = true;
+    }
+
+    // Sleep through the bulk of the wait, then see how late the sleep woke
+    auto spin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(spinMilliseconds));
+    auto wake = deadline - spin;
+    if (wake > now) {
+        std::this_thread::sleep_until(wake);
+        double late = std::chrono::duration<double, std::milli>(Clock::now() - wake).count();
+        // Jump straight up to a late wake with some headroom, come back down slowly
+        spinMilliseconds = std::min(std::max(std::max(late * 1.25, spinMilliseconds * 0.98), PACER_MIN_SPIN_MS), PACER_MAX_SPIN_MS);
+    }
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    deadline += period;
+} // wait
+
+void FramePacer::presented() {
+    auto now = Clock::now();
+    double period = targetPeriod();
+    if (period <= 0.0) {
+        havePresent = false;
+        return;
+    }
+    if (havePresent) {
+        double interval = std::chrono::duration<double, std::milli>(now - lastPresent).count();
+        double error = std::fabs(interval - period * 1000.0);
+        int bin = 0;
+        while ((bin < PACER_HISTOGRAM_BINS - 1) && (error >= binLimits[bin])) {
+            bin++;
+        }
+        histogram[bin]++;
+        intervals++;
+        intervalSum += interval;
+        intervalSquares += interval * interval;
+        worstError = std::max(worstError, error);
+        if (interval > period * 1000.0 * PACER_DROP_FACTOR) {
+            dropped++;
+        }
+    }
+    lastPresent = now;
+    havePresent = true;
+} // presented
+
+void FramePacer::report(std::ostream& out) const {
+    if (intervals == 0) {
+        return;
+    }
+    double mean = intervalSum / intervals;
+    double deviation = std::sqrt(std::max(intervalSquares / intervals - mean * mean, 0.0));
+    char line[192];
+    snprintf(line, sizeof(line), "Frame pacing: %llu intervals, mean %.2f ms, stddev %.2f ms, worst error %.2f ms, spin %.2f ms, "
+             "%llu dropped", static_cast<unsigned long long>(intervals), mean, deviation, worstError, spinMilliseconds,
+             static_cast<unsigned long long>(dropped));
+    out << line << std::endl;
+
+    for (int bin = 0; bin < PACER_HISTOGRAM_BINS; bin++) {
+        double share = 100.0 * histogram[bin] / intervals;
+        if (bin < PACER_HISTOGRAM_BINS - 1) {
+            snprintf(line, sizeof(line), "  off by < %5.2f ms %6.2f%% ", binLimits[bin], share);
+        } else {
+            snprintf(line, sizeof(line), "  off by >=%5.2f ms %6.2f%% ", binLimits[bin - 1], share);
+        }
+        out << line << std::string(static_cast<size_t>(share / 2.0 + 0.5), '#') << std::endl;
+    }
+} // report
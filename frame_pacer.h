@@ -0,0 +1,80 @@
+/*******************************************************************
+    Birthday Shader 2025 - frame pacing
+
+    With vsync off (V) the window used to draw as fast as it could,
+    keeping a core and the GPU flat out for frames nobody sees. The
+    pacer holds it to a target rate instead: it sleeps through most of
+    the wait and spins for the last stretch, since a sleep can wake late
+    but a spin can't. How much it leaves to the spin follows how late
+    the sleeps have actually been waking. While the window is unfocused
+    or iconified it drops to a low idle rate, vsync or not.
+
+    Every frame interval is also checked against the rate in effect
+    (the limit, or the display's refresh with vsync) and the error goes
+    into a histogram that is printed on exit. An interval longer than
+    PACER_DROP_FACTOR periods counts as a dropped frame.
+*******************************************************************/
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+constexpr double PACER_DEFAULT_LIMIT_FPS = 60.0;    // Vsync off
+constexpr double PACER_DEFAULT_IDLE_FPS = 10.0;     // Unfocused or iconified
+constexpr double PACER_MIN_SPIN_MS = 0.2;
+constexpr double PACER_MAX_SPIN_MS = 4.0;
+constexpr int PACER_HISTOGRAM_BINS = 8;             // |interval - period| below 0.1, 0.25, 0.5, 1, 2, 4, 8 ms, and above
+constexpr double PACER_DROP_FACTOR = 1.5;           // Intervals this many periods long missed at least one
+
+class FramePacer {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // limitFps 0 lets vsync-off frames run flat out; refreshRate 0 when the display's is unknown
+    void configure(double limitFps, double idleFps, double refreshRate);
+
+    void setVsync(bool on);
+    void setFocused(bool focused);
+    void setIconified(bool iconified);
+
+    // Call right before the swap: waits until this frame is due. Returns at once when nothing limits the rate
+    void wait();
+
+    // Call right after the swap
+    void presented();
+
+    void report(std::ostream& out) const;
+
+    bool vsyncOn() const { return vsync; }
+    bool idle() const { return !focused || iconified; }
+    uint64_t droppedFrames() const { return dropped; }
+
+private:
+    bool pacing() const { return idle() || (!vsync && (limit > 0.0)); }
+    double targetPeriod() const;            // Seconds, 0 when there is nothing to measure against
+    void restart();                         // The target changed: start the next frame afresh
+
+    double limit = PACER_DEFAULT_LIMIT_FPS;
+    double idleRate = PACER_DEFAULT_IDLE_FPS;
+    double refresh = 0.0;
+    bool vsync = true;
+    bool focused = true;
+    bool iconified = false;
+
+    Clock::time_point deadline;             // When the next frame is due
+    bool haveDeadline = false;
+    double spinMilliseconds = 1.0;          // Left to the spin at the end of every wait
+
+    Clock::time_point lastPresent;
+    bool havePresent = false;
+    uint64_t histogram[PACER_HISTOGRAM_BINS] = {};
+    uint64_t intervals = 0;
+    double intervalSum = 0.0;               // Milliseconds
+    double intervalSquares = 0.0;
+    double worstError = 0.0;
+    uint64_t dropped = 0;
+};
+
+#endif // FRAME_PACER_H
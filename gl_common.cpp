@@ -0,0 +1,154 @@
+/*******************************************************************
+    Birthday Shader 2025 - OpenGL setup shared by every GL front-end
+*******************************************************************/
+#include "gl_common.h"
+#include "embedded_files.h"
+#include "shader_include.h"
+
+#include <cstdlib>
+#include <iostream>
+
+const char* vertexShaderSource = R"(
+    #version 330 core
+    layout (location = 0) in vec2 aPos;
+    out vec2 fragCoord;
+
+    // birthday.shader's Animation block, member for member: a block shared between stages has to match
+    layout(std140) uniform Animation {
+        vec4 uLetterOffset[16];
+        mat2 uWobble;
+        float uScale;
+        float iTime;
+        vec2 iResolution;
+        float uRandom;
+    };
+
+    void main() {
+        gl_Position = vec4(aPos, 0.0, 1.0);
+        fragCoord = (aPos + 1.0) * 0.5 * iResolution; // Convert from [-1,1] to [0,screenSize]
+    }
+)";
+
+bool readShaderSource(const std::string& filename, std::string& source) {
+    std::string error;
+    return readShaderIncludes(filename, source, error);
+}
+
+bool loadShaderSource(const std::string& path, std::string& source, std::string& error) {
+    if (path.empty()) {
+        error = "birthday.shader was not built in";
+        return embeddedFile("birthday.shader", source);
+    }
+    return readShaderIncludes(path, source, error);
+}
+
+std::string loadShaderSource(const std::string& path) {
+    std::string source, error;
+    if (!loadShaderSource(path, source, error)) {
+        std::cerr << error << std::endl;
+        exit(1);
+    }
+    return source;
+}
+
+bool shaderCompiled(GLuint shader, std::string& log) {
+    int success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        char infoLog[512];
+        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+        log = infoLog;
+    }
+    return success != 0;
+}
+
+bool programLinked(GLuint program, std::string& log) {
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        char infoLog[512];
+        glGetProgramInfoLog(program, 512, nullptr, infoLog);
+        log = infoLog;
+    }
+    return success != 0;
+}
+
+void checkShaderCompilation(GLuint shader) {
+    std::string log;
+    if (!shaderCompiled(shader, log)) {
+        std::cerr << "Shader Compilation Error:\n" << log << std::endl;
+        exit(1);
+    }
+}
+
+std::string insertDefines(const std::string& source, const std::string& defines) {
+    // #version has to stay the first statement, so the defines go on the line after it
+    size_t version = source.find("#version");
+    if (version == std::string::npos) {
+        return defines + source;
+    }
+    size_t lineEnd = source.find('\n', version);
+    if (lineEnd == std::string::npos) {
+        return source + "\n" + defines;
+    }
+    return source.substr(0, lineEnd + 1) + defines + source.substr(lineEnd + 1);
+}
+
+GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    checkShaderCompilation(shader);
+    return shader;
+}
+
+GLuint buildShader(GLenum type, const char* source, std::string& error) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    std::string log;
+    if (!shaderCompiled(shader, log)) {
+        error = "Shader compilation failed:\n" + log;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+GLuint linkProgram(GLuint vertexShader, GLuint fragmentShader) {
+    GLuint shaderProgram = glCreateProgram();
+    glAttachShader(shaderProgram, vertexShader);
+    glAttachShader(shaderProgram, fragmentShader);
+    // Ask the driver to keep a binary that program_cache can read back
+    if (GLEW_ARB_get_program_binary) {
+        glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glLinkProgram(shaderProgram);
+    return shaderProgram;
+}
+
+void createFullscreenQuad(GLuint& vao, GLuint& vbo) {
+    float vertices[] = { -1.0f, -1.0f,  1.0f, -1.0f,  -1.0f, 1.0f,  1.0f, 1.0f };
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+}
+
+bool initGLEW() {
+    // Core profile contexts need this for GLEW to load everything past GL 1.1
+    glewExperimental = GL_TRUE;
+    GLenum result = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLEW built for GLX still loads every GL entry point for an EGL context,
+    // it only fails afterwards while looking for the (absent) X display
+    if (result == GLEW_ERROR_NO_GLX_DISPLAY) {
+        result = GLEW_OK;
+    }
+#endif
+    return result == GLEW_OK;
+}
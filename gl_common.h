@@ -0,0 +1,39 @@
+/*******************************************************************
+    Birthday Shader 2025 - OpenGL setup shared by every GL front-end
+    (the window, and the headless renderer)
+*******************************************************************/
+#ifndef GL_COMMON_H
+#define GL_COMMON_H
+
+#include <GL/glew.h>
+#include <string>
+
+// Vertex shader hard-coded GLSL
+extern const char* vertexShaderSource;
+
+// The fragment shader as built into the binary when path is empty, otherwise read from path with its
+// #include lines expanded; exits if there is none
+std::string loadShaderSource(const std::string& path);
+bool loadShaderSource(const std::string& path, std::string& source, std::string& error);
+void checkShaderCompilation(GLuint shader);
+
+// Non-fatal versions for reloading at runtime: report the problem instead of exiting
+bool readShaderSource(const std::string& filename, std::string& source);
+bool shaderCompiled(GLuint shader, std::string& log);
+bool programLinked(GLuint program, std::string& log);
+
+// Source with extra lines (usually #defines) placed right after its #version line
+std::string insertDefines(const std::string& source, const std::string& defines);
+
+GLuint compileShader(GLenum type, const char* source);
+// Non-fatal version: 0 when the source doesn't compile, with the info log in error
+GLuint buildShader(GLenum type, const char* source, std::string& error);
+GLuint linkProgram(GLuint vertexShader, GLuint fragmentShader);
+
+// Two-triangle strip covering the viewport, bound to attribute 0
+void createFullscreenQuad(GLuint& vao, GLuint& vbo);
+
+// Load GL entry points for the current context; works with GLX, WGL, CGL and EGL contexts
+bool initGLEW();
+
+#endif // GL_COMMON_H
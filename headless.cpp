@@ -0,0 +1,312 @@
+/*******************************************************************
+    Birthday Shader 2025 - headless offscreen rendering
+*******************************************************************/
+#include "headless.h"
+#include "gl_common.h"
+#include "image_io.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#if defined(__linux__)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+/***************************** HeadlessContext *****************************/
+
+#if defined(__linux__)
+
+namespace {
+
+bool hasExtension(const char* extensions, const char* name) {
+    if (!extensions) {
+        return false;
+    }
+    size_t length = strlen(name);
+    for (const char* p = strstr(extensions, name); p; p = strstr(p + length, name)) {
+        if (((p == extensions) || (p[-1] == ' ')) && ((p[length] == ' ') || (p[length] == '\0'))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+EGLDisplay openDisplay() {
+    EGLDisplay display = EGL_NO_DISPLAY;
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+    // Mesa's surfaceless platform needs neither X11, Wayland nor a DRM device node
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay) {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+#endif
+    if (display == EGL_NO_DISPLAY) {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    return display;
+}
+
+} // namespace
+
+HeadlessContext::~HeadlessContext() {
+    release();
+}
+
+bool HeadlessContext::create(std::string& error) {
+    EGLDisplay eglDisplay = openDisplay();
+    if ((eglDisplay == EGL_NO_DISPLAY) || !eglInitialize(eglDisplay, nullptr, nullptr)) {
+        error = "no EGL display available";
+        return false;
+    }
+    display = eglDisplay;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        error = "EGL driver has no desktop OpenGL support";
+        return false;
+    }
+
+    const char* extensions = eglQueryString(eglDisplay, EGL_EXTENSIONS);
+    bool surfaceless = hasExtension(extensions, "EGL_KHR_surfaceless_context");
+    bool configless = surfaceless && hasExtension(extensions, "EGL_KHR_no_config_context");
+
+    EGLConfig config = nullptr;
+    if (!configless) {
+        const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+            EGL_NONE
+        };
+        EGLint count = 0;
+        if (!eglChooseConfig(eglDisplay, configAttribs, &config, 1, &count) || (count == 0)) {
+            error = "no EGL config for OpenGL pbuffers";
+            return false;
+        }
+    }
+
+    // Ask for OpenGL version 3.3, same as the window
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+    if (eglContext == EGL_NO_CONTEXT) {
+        error = "failed to create an OpenGL 3.3 core context";
+        return false;
+    }
+    context = eglContext;
+
+    if (!surfaceless) {
+        // Everything is drawn into an FBO, the pbuffer only exists to make the context current
+        const EGLint pbufferAttribs[] = { EGL_WIDTH, 16, EGL_HEIGHT, 16, EGL_NONE };
+        EGLSurface eglSurface = eglCreatePbufferSurface(eglDisplay, config, pbufferAttribs);
+        if (eglSurface == EGL_NO_SURFACE) {
+            error = "failed to create a pbuffer surface";
+            return false;
+        }
+        surface = eglSurface;
+    }
+
+    if (!makeCurrent()) {
+        error = "failed to make the context current";
+        return false;
+    }
+    return true;
+}
+
+bool HeadlessContext::makeCurrent() {
+    EGLSurface eglSurface = surface ? static_cast<EGLSurface>(surface) : EGL_NO_SURFACE;
+    return eglMakeCurrent(static_cast<EGLDisplay>(display), eglSurface, eglSurface,
+                          static_cast<EGLContext>(context)) == EGL_TRUE;
+}
+
+void HeadlessContext::release() {
+    if (!display) {
+        return;
+    }
+    EGLDisplay eglDisplay = static_cast<EGLDisplay>(display);
+    eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (surface) {
+        eglDestroySurface(eglDisplay, static_cast<EGLSurface>(surface));
+    }
+    if (context) {
+        eglDestroyContext(eglDisplay, static_cast<EGLContext>(context));
+    }
+    // The display is shared by every context in the process, so it is not terminated here
+    display = context = surface = nullptr;
+}
+
+#else
+
+// No EGL outside Linux: macOS and Windows keep using the window
+HeadlessContext::~HeadlessContext() {
+}
+
+bool HeadlessContext::create(std::string& error) {
+    error = "headless rendering needs EGL, which is only available on Linux";
+    return false;
+}
+
+bool HeadlessContext::makeCurrent() {
+    return false;
+}
+
+void HeadlessContext::release() {
+}
+
+#endif
+
+/***************************** OffscreenTarget *****************************/
+
+OffscreenTarget::~OffscreenTarget() {
+    destroy();
+}
+
+bool OffscreenTarget::create(uint32_t w, uint32_t h) {
+    destroy();
+    width = w;
+    height = h;
+
+    glGenTextures(1, &colorTexture);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+void OffscreenTarget::destroy() {
+    if (framebuffer) {
+        glDeleteFramebuffers(1, &framebuffer);
+        framebuffer = 0;
+    }
+    if (colorTexture) {
+        glDeleteTextures(1, &colorTexture);
+        colorTexture = 0;
+    }
+}
+
+void OffscreenTarget::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+}
+
+/***************************** --headless *****************************/
+
+namespace {
+
+// Accept exactly one integer conversion such as %d or %05d, nothing that could read a missing argument
+bool isFramePattern(const std::string& pattern) {
+    size_t percent = pattern.find('%');
+    if (percent == std::string::npos) {
+        return false;
+    }
+    size_t i = percent + 1;
+    while ((i < pattern.size()) && (pattern[i] >= '0') && (pattern[i] <= '9')) {
+        i++;
+    }
+    return (i < pattern.size()) && (pattern[i] == 'd') && (pattern.find('%', i) == std::string::npos);
+}
+
+std::string framePath(const std::string& pattern, uint32_t frame) {
+    char path[1024];
+    snprintf(path, sizeof(path), pattern.c_str(), static_cast<int>(frame));
+    return path;
+}
+
+} // namespace
+
+int runHeadlessMode(const HeadlessOptions& options) {
+    bool exporting = (options.exportFormat != EXPORT_NONE);
+    bool perFrameFiles = !exporting && isFramePattern(options.outputPattern);
+    if (!exporting && !options.outputPattern.empty() && !perFrameFiles && (options.outputPattern.find('%') != std::string::npos)) {
+        std::cerr << "Invalid output pattern: " << options.outputPattern << " (use a single %d, e.g. frame_%04d.ppm)"
+                  << std::endl;
+        return 1;
+    }
+
+    HeadlessContext context;
+    std::string error;
+    if (!context.create(error)) {
+        std::cerr << "Failed to create headless OpenGL context: " << error << std::endl;
+        return -1;
+    }
+    if (!initGLEW()) {
+        std::cerr << "Failed to initialize GLEW" << std::endl;
+        return -1;
+    }
+
+    // Keep stdout clean when the frames themselves go there
+    std::string exportPath = options.outputPattern.empty() ? "-" : options.outputPattern;
+    std::ostream& log = (exporting && (exportPath == "-")) ? std::cerr : std::cout;
+    log << "GL_RENDERER: " << glGetString(GL_RENDERER) << std::endl;
+
+    // Load and compile fragment shader
+    Scene scene;
+    if (!scene.create(options.scene, loadShaderSource(options.shaderPath), log, error)) {
+        std::cerr << error << std::endl;
+        return -1;
+    }
+    scene.setRandom(options.uRandom);
+
+    OffscreenTarget target;
+    if (!target.create(options.width, options.height)) {
+        std::cerr << "Failed to create " << options.width << "x" << options.height << " framebuffer" << std::endl;
+        return -1;
+    }
+    target.bind();
+
+    uint32_t frameCount = static_cast<uint32_t>(std::max(1.0, std::ceil(double(options.endTime - options.startTime) * options.fps)));
+    std::vector<uint8_t> pixels((exporting || options.outputPattern.empty()) ? 0 : size_t(options.width) * options.height * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    FrameExporter exporter;
+    if (exporting && !exporter.open(exportPath, options.exportFormat, options.width, options.height, options.fps)) {
+        std::cerr << "Failed to open export output: " << exportPath << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frameCount; frame++) {
+        float time = options.startTime + static_cast<float>(frame) / options.fps;
+        scene.render(time, options.width, options.height);
+
+        bool lastFrame = (frame + 1 == frameCount);
+        if (exporting) {
+            exporter.capture();
+        } else if (perFrameFiles || (lastFrame && !options.outputPattern.empty())) {
+            glReadPixels(0, 0, options.width, options.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            std::string path = perFrameFiles ? framePath(options.outputPattern, frame) : options.outputPattern;
+            if (!writePPM(path, pixels.data(), options.width, options.height, true)) {
+                std::cerr << "Failed to write image: " << path << std::endl;
+                return 1;
+            }
+        }
+    }
+    bool exported = !exporting || exporter.finish(log);
+    glFinish();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    log << "Rendered " << frameCount << " frames at " << options.width << "x" << options.height
+              << " for iTime " << options.startTime << " to " << options.endTime << " s in " << seconds << " s ("
+              << frameCount / seconds << " frames/s)" << std::endl;
+
+    target.destroy();
+    scene.destroy();
+    return exported ? 0 : 1;
+} // runHeadlessMode
@@ -0,0 +1,74 @@
+/*******************************************************************
+    Birthday Shader 2025 - headless offscreen rendering
+
+    Renders birthday.shader into a framebuffer object through an EGL
+    context with no window and no display server, so Mesa's llvmpipe
+    on a display-less server is enough. Surfaceless contexts are used
+    when the driver offers them and a tiny pbuffer otherwise.
+*******************************************************************/
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include "frame_export.h"
+#include "scene.h"
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+
+class HeadlessContext {
+public:
+    HeadlessContext() = default;
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    // Create an OpenGL 3.3 core context and make it current on the calling thread
+    bool create(std::string& error);
+    bool makeCurrent();
+    void release();
+
+private:
+    // EGLDisplay / EGLContext / EGLSurface, kept opaque so EGL stays out of this header
+    void* display = nullptr;
+    void* context = nullptr;
+    void* surface = nullptr;
+};
+
+// Color texture + framebuffer object to render into instead of a window's back buffer
+class OffscreenTarget {
+public:
+    OffscreenTarget() = default;
+    ~OffscreenTarget();
+
+    OffscreenTarget(const OffscreenTarget&) = delete;
+    OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+    bool create(uint32_t width, uint32_t height);
+    void destroy();
+    void bind() const;
+
+    GLuint framebuffer = 0;
+    GLuint colorTexture = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+struct HeadlessOptions {
+    uint32_t width;
+    uint32_t height;
+    float startTime;                        // iTime of the first frame, in seconds
+    float endTime;                          // Frames are rendered for iTime in [startTime, endTime)
+    float fps;                              // iTime step is 1 / fps
+    float uRandom;
+    std::string outputPattern;              // printf-style "frame_%04d.ppm", or a single file for the last frame
+    ExportFormat exportFormat = EXPORT_NONE;  // Stream every frame to outputPattern ("-" = stdout) instead
+    std::string shaderPath;                 // Built-in shader if empty
+    SceneOptions scene;
+};
+
+// --headless: render a time range into an FBO and optionally write every frame as a PPM or a stream
+int runHeadlessMode(const HeadlessOptions& options);
+
+#endif // HEADLESS_H
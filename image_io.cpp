@@ -0,0 +1,158 @@
+/*******************************************************************
+    Birthday Shader 2025 - still image output
+*******************************************************************/
+#include "image_io.h"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+bool writePPM(const std::string& path, const uint8_t* rgba, uint32_t width, uint32_t height, bool bottomUp) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    file << "P6\n" << width << " " << height << "\n255\n";
+    std::vector<char> row(width * 3);
+    for (uint32_t y = 0; y < height; y++) {
+        uint32_t srcRow = bottomUp ? (height - 1 - y) : y;
+        const uint8_t* src = rgba + size_t(srcRow) * width * 4;
+        for (uint32_t x = 0; x < width; x++) {
+            row[x * 3 + 0] = static_cast<char>(src[x * 4 + 0]);
+            row[x * 3 + 1] = static_cast<char>(src[x * 4 + 1]);
+            row[x * 3 + 2] = static_cast<char>(src[x * 4 + 2]);
+        }
+        file.write(row.data(), row.size());
+    }
+    return file.good();
+}
+
+bool parseImageFormat(const std::string& text, ImageFormat& format) {
+    if (text == "png") {
+        format = IMAGE_PNG;
+    } else if (text == "ppm") {
+        format = IMAGE_PPM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* imageFormatName(ImageFormat format) {
+    return (format == IMAGE_PNG) ? "png" : "ppm";
+}
+
+namespace {
+
+constexpr uint32_t DEFLATE_STORED_MAX = 65535;  // Bytes in one stored block
+
+// Built on first use; static initialization is thread-safe, and PNGs are written from several threads at once
+struct CrcTable {
+    uint32_t entries[256];
+
+    CrcTable() {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+            }
+            entries[n] = c;
+        }
+    }
+};
+
+uint32_t crc32(uint32_t crc, const uint8_t* data, size_t size) {
+    static const CrcTable table;
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table.entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void putBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void writeChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> length, crc;
+    putBigEndian(length, static_cast<uint32_t>(data.size()));
+    const uint8_t* typeBytes = reinterpret_cast<const uint8_t*>(type);
+    putBigEndian(crc, crc32(crc32(0, typeBytes, 4), data.data(), data.size()));
+    file.write(reinterpret_cast<const char*>(length.data()), length.size());
+    file.write(type, 4);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    file.write(reinterpret_cast<const char*>(crc.data()), crc.size());
+}
+
+} // namespace
+
+bool writePNG(const std::string& path, const uint8_t* rgba, uint32_t width, uint32_t height, bool bottomUp) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<uint8_t> header;
+    putBigEndian(header, width);
+    putBigEndian(header, height);
+    header.push_back(8);                    // Bits per channel
+    header.push_back(2);                    // RGB
+    header.push_back(0);                    // Deflate
+    header.push_back(0);                    // Adaptive filtering, every row filter 0 (none) here
+    header.push_back(0);                    // Not interlaced
+    writeChunk(file, "IHDR", header);
+
+    // Filter byte + RGB per row, cut into stored deflate blocks inside a zlib stream
+    size_t rowSize = size_t(width) * 3 + 1;
+    size_t rawSize = rowSize * height;
+    std::vector<uint8_t> raw(rawSize);
+    for (uint32_t y = 0; y < height; y++) {
+        uint32_t srcRow = bottomUp ? (height - 1 - y) : y;
+        const uint8_t* src = rgba + size_t(srcRow) * width * 4;
+        uint8_t* dst = raw.data() + y * rowSize;
+        dst[0] = 0;
+        for (uint32_t x = 0; x < width; x++) {
+            dst[1 + x * 3 + 0] = src[x * 4 + 0];
+            dst[1 + x * 3 + 1] = src[x * 4 + 1];
+            dst[1 + x * 3 + 2] = src[x * 4 + 2];
+        }
+    }
+    std::vector<uint8_t> idat;
+    idat.reserve(rawSize + (rawSize / DEFLATE_STORED_MAX + 1) * 5 + 6);
+    idat.push_back(0x78);                   // zlib: deflate with a 32K window, no dictionary
+    idat.push_back(0x01);
+    size_t offset = 0;
+    do {
+        uint32_t size = static_cast<uint32_t>(std::min<size_t>(rawSize - offset, DEFLATE_STORED_MAX));
+        bool last = (offset + size == rawSize);
+        idat.push_back(last ? 1 : 0);       // BFINAL, BTYPE 00 = stored
+        idat.push_back(static_cast<uint8_t>(size));
+        idat.push_back(static_cast<uint8_t>(size >> 8));
+        idat.push_back(static_cast<uint8_t>(~size));
+        idat.push_back(static_cast<uint8_t>(~size >> 8));
+        idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + size);
+        offset += size;
+    } while (offset < rawSize);
+
+    uint32_t a = 1, b = 0;                  // Adler-32 of the uncompressed data
+    for (size_t i = 0; i < rawSize; i++) {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    putBigEndian(idat, (b << 16) | a);
+    writeChunk(file, "IDAT", idat);
+    writeChunk(file, "IEND", std::vector<uint8_t>());
+    return file.good();
+} // writePNG
+
+bool writeImage(const std::string& path, ImageFormat format, const uint8_t* rgba, uint32_t width, uint32_t height,
+                bool bottomUp) {
+    return (format == IMAGE_PNG) ? writePNG(path, rgba, width, height, bottomUp) :
+        writePPM(path, rgba, width, height, bottomUp);
+}
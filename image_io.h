@@ -0,0 +1,33 @@
+/*******************************************************************
+    Birthday Shader 2025 - still image output
+
+    PPM, and PNG written without a zlib dependency: the image data goes
+    into stored (uncompressed) deflate blocks, so files are about as big
+    as the PPM but open anywhere.
+*******************************************************************/
+#ifndef IMAGE_IO_H
+#define IMAGE_IO_H
+
+#include <cstdint>
+#include <string>
+
+enum ImageFormat {
+    IMAGE_PNG,
+    IMAGE_PPM
+};
+
+bool parseImageFormat(const std::string& text, ImageFormat& format);
+const char* imageFormatName(ImageFormat format);   // Also the file extension
+
+// Write 4-byte RGBA pixels as a binary PPM. bottomUp = rows come straight from glReadPixels
+bool writePPM(const std::string& path, const uint8_t* rgba, uint32_t width, uint32_t height,
+              bool bottomUp = false);
+
+// Same, as an 8-bit RGB PNG
+bool writePNG(const std::string& path, const uint8_t* rgba, uint32_t width, uint32_t height,
+              bool bottomUp = false);
+
+bool writeImage(const std::string& path, ImageFormat format, const uint8_t* rgba, uint32_t width, uint32_t height,
+                bool bottomUp = false);
+
+#endif // IMAGE_IO_H
@@ -0,0 +1,241 @@
+/*******************************************************************
+    Birthday Shader 2025 - letter distance-field atlas
+*******************************************************************/
+#include "letter_atlas.h"
+#include "cpu_shader.h"
+#include "gl_common.h"
+
+#include <chrono>
+#include <cstring>
+
+using namespace cpushader;
+
+namespace {
+
+typedef Vec2<float> P;
+
+// Stroke width and inner variant of one of the three passes (see the DRAW_GLYPH_ macros in birthday.shader)
+struct StrokeSet {
+    float t;
+    float inner;                            // The bool letters use 0 / 1
+};
+
+// Shadow, outline and fill, in channel order
+struct GlyphStrokes {
+    char letter;
+    StrokeSet passes[3];
+};
+
+// Layer order matches the GLYPH_ defines in letters.glsl
+const GlyphStrokes glyphs[LETTER_ATLAS_LAYERS] = {
+    { 'A', { { .05f, 0.0f }, { .055f, 0.0f }, { .044f, 1.0f } } },
+    { 'B', { { .05f, 0.0f }, { .06f, 0.0f }, { .046f, .01f } } },
+    { 'D', { { .05f, 0.0f }, { .06f, 0.0f }, { .046f, .01f } } },
+    { 'H', { { .06f, 0.0f }, { .06f, 0.0f }, { .048f, 0.0f } } },
+    { 'I', { { .06f, 0.0f }, { .06f, 0.0f }, { .048f, 0.0f } } },
+    { 'P', { { .05f, 0.0f }, { .06f, 0.0f }, { .046f, .01f } } },
+    { 'R', { { .05f, 0.0f }, { .06f, 0.0f }, { .046f, .01f } } },
+    { 'T', { { .06f, 0.0f }, { .06f, 0.0f }, { .048f, 1.0f } } },
+    { 'Y', { { .05f, 0.0f }, { .06f, 0.0f }, { .048f, 1.0f } } },
+};
+
+// The letter functions of cpu_shader.h as distances: strokes unite with min, clipping boxes cut with max
+float ring(const P& p, float radius, float t) {
+    return std::fabs(sdBox(p, .1f, .0001f) - radius) - t;
+}
+
+float distanceA(const P& uv, float t, float inner) {
+    float a = std::min(sdBox(rotate(shift(uv, .1f, 0.0f), ROT_A_LEFT.c, ROT_A_LEFT.s), t, .25f + t),
+                       sdBox(rotate(shift(uv, -.1f, 0.0f), ROT_A_RIGHT.c, ROT_A_RIGHT.s), t, .25f + t));
+    a = std::min(a, sdBox(shift(uv, 0.0f, .05f), .1f, t * .8f));
+    a = std::max(a, sdBox(uv, .26f, .26f));
+    if (inner > 0.0f)
+        a = std::max(a, sdBox(uv, .26f, .25f));
+    return a;
+}
+
+float distanceB(const P& uv, float t, float inner) {
+    float b = sdBox(shift(uv, .12f, 0.0f), t, .2f + t);
+    b = std::min(b, ring(shift(uv, t + inner, -.12f), .09f, t * .9f));
+    b = std::min(b, ring(shift(uv, t + inner, .12f), .09f, t * .9f));
+    b = std::max(b, sdBox(shift(uv, -.04f, 0.0f), .22f, .28f));
+    if (inner > 0.0f)
+        b = std::max(b, sdBox(shift(uv, -.0435f, 0.0f), .21f, .28f));
+    return b;
+}
+
+float distanceD(const P& uv, float t, float inner) {
+    float d = std::min(sdBox(shift(uv, .12f, 0.0f), t, .2f + t), ring(shift(uv, t + inner + .06f, 0.0f), .202f, t));
+    d = std::max(d, sdBox(shift(uv, -.04f, 0.0f), .22f, .28f));
+    if (inner > 0.0f)
+        d = std::max(d, sdBox(shift(uv, -.07f, 0.0f), .236f, .26f));
+    return d;
+}
+
+float distanceH(const P& uv, float t, float) {
+    float h = std::min(sdBox(shift(uv, .12f, 0.0f), t, .2f + t), sdBox(shift(uv, -.12f, 0.0f), t, .2f + t));
+    return std::min(h, sdBox(uv, .1f, t));
+}
+
+float distanceI(const P& uv, float t, float) {
+    return sdBox(uv, t, .2f + t);
+}
+
+float distanceP(const P& uv, float t, float inner) {
+    float p = std::min(sdBox(shift(uv, .12f, 0.0f), t, .2f + t), ring(shift(uv, t + inner, -.106f), .1f, t));
+    p = std::max(p, sdBox(shift(uv, -.04f, 0.0f), .22f, .28f));
+    if (inner > 0.0f)
+        p = std::max(p, sdBox(shift(uv, -.043f, 0.0f), .21f, .28f));
+    return p;
+}
+
+float distanceR(const P& uv, float t, float inner) {
+    float r = std::min(sdBox(shift(uv, .12f, 0.0f), t, .2f + t), ring(shift(uv, t + inner, -.106f), .1f, t));
+    r = std::min(r, sdBox(rotate(shift(uv, -.1f, .18f), ROT_R_LEG.c, ROT_R_LEG.s), t, .2f));
+    r = std::max(r, sdBox(shift(uv, -.04f, -.02f), .22f, .28f));
+    if (inner > 0.0f)
+        r = std::max(r, sdBox(shift(uv, -.04f, -.02f - inner), .207f, .28f));
+    return r;
+}
+
+float distanceT(const P& uv, float t, float inner) {
+    float tt = std::min(sdBox(shift(uv, 0.0f, .03f), t, .23f), sdBox(shift(uv, 0.0f, -.2f), .23f, t));
+    if (inner > 0.0f)
+        tt = std::max(tt, sdBox(uv, .22f, .25f));
+    return tt;
+}
+
+float distanceY(const P& uv, float t, float inner) {
+    float y = sdBox(shift(uv, 0.0f, .14f), t, .12f);
+    y = std::min(y, sdBox(rotate(shift(uv, .1f, -.14f), ROT_Y_LEFT.c, ROT_Y_LEFT.s), t, .24f));
+    y = std::min(y, sdBox(rotate(shift(uv, -.1f, -.14f), ROT_Y_RIGHT.c, ROT_Y_RIGHT.s), t, .24f));
+    y = std::max(y, sdBox(shift(uv, 0.0f, .2f), .45f, .45f));
+    if (inner > 0.0f)
+        y = std::max(y, sdBox(shift(uv, 0.0f, .005f), .3f, .245f));
+    return y;
+}
+
+float glyphDistance(char letter, const P& uv, const StrokeSet& strokes) {
+    switch (letter) {
+    case 'A': return distanceA(uv, strokes.t, strokes.inner);
+    case 'B': return distanceB(uv, strokes.t, strokes.inner);
+    case 'D': return distanceD(uv, strokes.t, strokes.inner);
+    case 'H': return distanceH(uv, strokes.t, strokes.inner);
+    case 'I': return distanceI(uv, strokes.t, strokes.inner);
+    case 'P': return distanceP(uv, strokes.t, strokes.inner);
+    case 'R': return distanceR(uv, strokes.t, strokes.inner);
+    case 'T': return distanceT(uv, strokes.t, strokes.inner);
+    default:  return distanceY(uv, strokes.t, strokes.inner);
+    }
+}
+
+const char* modeNames[] = { "analytic", "atlas" };
+
+constexpr uint32_t REACH_GRID = 128;            // Samples per side when measuring glyphReach()
+constexpr float WIDEST_EDGE = .06f;             // Every pass draws nothing once its distance passes this
+
+} // namespace
+
+bool parseLetterMode(const char* name, LetterMode& mode) {
+    for (int i = 0; i < 2; i++) {
+        if (strcmp(name, modeNames[i]) == 0) {
+            mode = static_cast<LetterMode>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* letterModeName(LetterMode mode) {
+    return modeNames[mode];
+}
+
+const char* letterShaderDefines(LetterMode mode) {
+    return (mode == LETTERS_ATLAS) ? "#define LETTER_ATLAS\n" : "";
+}
+
+void bakeLetterAtlas(std::vector<float>& texels) {
+    const uint32_t size = LETTER_ATLAS_SIZE;
+    const float texel = 2.0f * LETTER_ATLAS_EXTENT / size;
+    texels.resize(size_t(LETTER_ATLAS_LAYERS) * size * size * 3);
+
+    float* out = texels.data();
+    for (const GlyphStrokes& glyph : glyphs) {
+        for (uint32_t y = 0; y < size; y++) {
+            for (uint32_t x = 0; x < size; x++) {
+                // Texel centres, so GL_LINEAR at (uv / extent + 1) / 2 reproduces the distance
+                P uv = { -LETTER_ATLAS_EXTENT + (x + 0.5f) * texel, -LETTER_ATLAS_EXTENT + (y + 0.5f) * texel };
+                for (const StrokeSet& strokes : glyph.passes) {
+                    *out++ = glyphDistance(glyph.letter, uv, strokes);
+                }
+            }
+        }
+    }
+}
+
+float glyphReach() {
+    static float reach = 0.0f;
+    if (reach > 0.0f) {
+        return reach;
+    }
+    const float step = 2.0f * LETTER_ATLAS_EXTENT / REACH_GRID;
+    for (const GlyphStrokes& glyph : glyphs) {
+        for (uint32_t y = 0; y <= REACH_GRID; y++) {
+            for (uint32_t x = 0; x <= REACH_GRID; x++) {
+                P uv = { -LETTER_ATLAS_EXTENT + x * step, -LETTER_ATLAS_EXTENT + y * step };
+                for (const StrokeSet& strokes : glyph.passes) {
+                    // Distances change no faster than position, so a drawn point between the samples
+                    // has a sample within a cell diagonal that passes this looser test
+                    if (glyphDistance(glyph.letter, uv, strokes) < WIDEST_EDGE + step) {
+                        reach = std::max(reach, std::sqrt(uv.x * uv.x + uv.y * uv.y));
+                    }
+                }
+            }
+        }
+    }
+    reach += step;
+    return reach;
+}
+
+/***************************** LetterAtlas *****************************/
+
+LetterAtlas::~LetterAtlas() {
+    destroy();
+}
+
+void LetterAtlas::destroy() {
+    if (texture) {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+}
+
+bool LetterAtlas::create() {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<float> texels;
+    bakeLetterAtlas(texels);
+
+    glGenTextures(1, &texture);
+    glActiveTexture(GL_TEXTURE0 + LETTER_ATLAS_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGB16F, LETTER_ATLAS_SIZE, LETTER_ATLAS_SIZE, LETTER_ATLAS_LAYERS, 0,
+                 GL_RGB, GL_FLOAT, texels.data());
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glActiveTexture(GL_TEXTURE0);
+
+    bakeTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return texture != 0;
+}
+
+void LetterAtlas::bind() const {
+    glActiveTexture(GL_TEXTURE0 + LETTER_ATLAS_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void LetterAtlas::bindSampler(const ShaderProgram& program) {
+    program.setSampler("uLetterAtlas", LETTER_ATLAS_TEXTURE_UNIT);
+}
@@ -0,0 +1,78 @@
+/*******************************************************************
+    Birthday Shader 2025 - letter distance-field atlas
+
+    Bakes the nine letter shapes (A B D H I P R T Y) into a 2D array
+    texture once at startup. Each layer holds three signed distances,
+    one per stroke set the shader draws with: the shadow, the white
+    outline and the coloured fill (the fill strokes are thinner and
+    some letters use an inner variant). With LETTER_ATLAS defined the
+    shader does one texture fetch per letter instead of evaluating a
+    handful of rotated sdBox calls three times over.
+
+    Strokes are combined with min (union) and max (the clipping boxes)
+    rather than by adding smoothsteps, so where two strokes overlap the
+    atlas no longer doubles up the coverage the way the analytic
+    functions do. --bench --letters both measures the difference.
+*******************************************************************/
+#ifndef LETTER_ATLAS_H
+#define LETTER_ATLAS_H
+
+#include "shader_program.h"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+constexpr uint32_t LETTER_ATLAS_SIZE = 256;     // Texels per side of each layer
+constexpr float LETTER_ATLAS_EXTENT = 0.75f;    // Layers cover letter space [-extent, extent]^2
+constexpr uint32_t LETTER_ATLAS_LAYERS = 9;
+constexpr GLint LETTER_ATLAS_TEXTURE_UNIT = 1;  // Unit 0 is left to the upscale pass
+
+enum LetterMode {
+    LETTERS_ANALYTIC,                       // Evaluate the letter functions per pixel (the original)
+    LETTERS_ATLAS
+};
+
+constexpr LetterMode LETTERS_DEFAULT = LETTERS_ANALYTIC;  // Matches the original exactly; compare with --bench --letters both
+
+bool parseLetterMode(const char* name, LetterMode& mode);
+const char* letterModeName(LetterMode mode);
+
+// Lines for insertDefines(): LETTER_ATLAS for the atlas, nothing for analytic
+const char* letterShaderDefines(LetterMode mode);
+
+// Distances for every layer, LETTER_ATLAS_SIZE^2 RGB texels per layer, row 0 at -extent
+void bakeLetterAtlas(std::vector<float>& texels);
+
+// Distance from a letter's origin (in its own frame) beyond which no glyph draws anything, shadow included
+float glyphReach();
+
+class LetterAtlas {
+public:
+    LetterAtlas() = default;
+    ~LetterAtlas();
+
+    LetterAtlas(const LetterAtlas&) = delete;
+    LetterAtlas& operator=(const LetterAtlas&) = delete;
+
+    // Bake and upload; needs a current context. Leaves the texture bound to LETTER_ATLAS_TEXTURE_UNIT
+    bool create();
+    void destroy();
+
+    // Bind the texture to LETTER_ATLAS_TEXTURE_UNIT again, after other GL code may have used the unit
+    void bind() const;
+
+    // Point the program's uLetterAtlas sampler at the atlas unit, with the program in use (harmless for
+    // analytic programs)
+    static void bindSampler(const ShaderProgram& program);
+
+    double bakeMilliseconds() const { return bakeTime; }
+
+private:
+    GLuint texture = 0;
+    double bakeTime = 0.0;
+};
+
+#endif // LETTER_ATLAS_H
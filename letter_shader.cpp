@@ -0,0 +1,92 @@
+/*******************************************************************
+    Birthday Shader 2025 - letter table to shader
+*******************************************************************/
+#include "letter_shader.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const char* codeNames[] = { "unrolled", "uniforms" };
+
+// Shortest literal that reads back as the same float, so the compiler sees exactly the table's value
+std::string glslFloat(float value) {
+    if (value == 0.0f) {
+        return "0.0";
+    }
+    char text[32];
+    std::string literal;
+    for (int digits = 1; (digits <= 9) && literal.empty(); digits++) {
+        snprintf(text, sizeof(text), "%.*g", digits, value);
+        if ((strchr(text, 'e') == nullptr) && (std::strtof(text, nullptr) == value)) {
+            literal = text;
+        }
+    }
+    if (literal.empty()) {
+        snprintf(text, sizeof(text), "%.9g", value);
+        literal = text;
+    }
+    if (literal.find_first_of(".e") == std::string::npos) {
+        literal += ".0";
+    }
+    return literal;
+}
+
+std::string unrolledBlocks(const LetterTable& table) {
+    std::string code = "// Generated from the letter table by letter_shader.cpp\n#define LETTER_BLOCKS";
+    for (size_t i = 0; i < table.letters.size(); i++) {
+        const LetterSpec& letter = table.letters[i];
+        std::string index = std::to_string(i);
+        code += " \\\n    if (LETTER_VISIBLE(" + index + ")) { \\\n";
+        code += "        SETUP_LETTER(" + index + "); \\\n";
+        code += std::string("        DRAW_GLYPH_") + letter.glyph + "(mix(white, vec3(" + glslFloat(letter.color[0]) + ", " +
+            glslFloat(letter.color[1]) + ", " + glslFloat(letter.color[2]) + "), " +
+            (letter.bottomRow ? "botGrad" : "topGrad") + ")); \\\n";
+        code += "    }";
+    }
+    return code + "\n";
+}
+
+} // namespace
+
+bool parseLetterCode(const char* name, LetterCode& code) {
+    for (int i = 0; i < 2; i++) {
+        if (strcmp(name, codeNames[i]) == 0) {
+            code = static_cast<LetterCode>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* letterCodeName(LetterCode code) {
+    return codeNames[code];
+}
+
+std::string letterTableDefines(const LetterTable& table, LetterCode code) {
+    return (code == LETTER_CODE_UNIFORMS) ? "#define LETTER_UNIFORMS\n" : unrolledBlocks(table);
+}
+
+void setLetterUniforms(const ShaderProgram& program, const LetterTable& table) {
+    GLint countLocation = program.location("uLetterCount");
+    if (countLocation < 0) {
+        return;                             // Unrolled
+    }
+
+    // Packed as the LETTER_UNIFORMS section of birthday.shader reads them
+    GLsizei count = static_cast<GLsizei>(table.letters.size());
+    std::vector<float> colors;
+    std::vector<GLint> glyphs;
+    for (const LetterSpec& letter : table.letters) {
+        float letterColor[4] = { letter.color[0], letter.color[1], letter.color[2], letter.bottomRow ? 1.0f : 0.0f };
+        colors.insert(colors.end(), letterColor, letterColor + 4);
+        glyphs.push_back(glyphIndex(letter.glyph));
+    }
+
+    glUniform1i(countLocation, count);
+    glUniform4fv(program.location("uLetterColor"), count, colors.data());
+    glUniform1iv(program.location("uLetterGlyph"), count, glyphs.data());
+}
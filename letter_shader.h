@@ -0,0 +1,40 @@
+/*******************************************************************
+    Birthday Shader 2025 - letter table to shader
+
+    Turns the letter table into birthday.shader code, one of two ways.
+    Unrolled, every letter becomes its own block in a generated
+    LETTER_BLOCKS #define with its glyph and colour written in as
+    literals, like the hand-written blocks it replaces, so the compiler
+    folds them into the code. With uniforms the shader loops over the
+    table held in uniform arrays instead: one program for any message,
+    at the cost of branching on every letter's glyph per pixel. Either
+    way each letter's position comes from the Animation block
+    (animation_block.h). --bench --letter-code both times the two.
+*******************************************************************/
+#ifndef LETTER_SHADER_H
+#define LETTER_SHADER_H
+
+#include "letters.h"
+#include "shader_program.h"
+
+#include <GL/glew.h>
+
+#include <string>
+
+enum LetterCode {
+    LETTER_CODE_UNROLLED,                   // LETTER_BLOCKS generated from the table
+    LETTER_CODE_UNIFORMS                    // LETTER_UNIFORMS: the table in uniform arrays
+};
+
+constexpr LetterCode LETTER_CODE_DEFAULT = LETTER_CODE_UNROLLED;
+
+bool parseLetterCode(const char* name, LetterCode& code);
+const char* letterCodeName(LetterCode code);
+
+// Lines for insertDefines()
+std::string letterTableDefines(const LetterTable& table, LetterCode code);
+
+// Upload the table to a LETTER_UNIFORMS program in use (harmless for unrolled programs)
+void setLetterUniforms(const ShaderProgram& program, const LetterTable& table);
+
+#endif // LETTER_SHADER_H
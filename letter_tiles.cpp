@@ -0,0 +1,117 @@
+/*******************************************************************
+    Birthday Shader 2025 - per-tile letter culling
+*******************************************************************/
+#include "letter_tiles.h"
+#include "animation.h"
+#include "letter_atlas.h"
+#include "letters.h"
+
+#include <algorithm>
+#include <cmath>
+
+const char* letterTileDefines(bool culling) {
+    return culling ? "#define LETTER_TILES\n" : "";
+}
+
+void binLetters(const LetterTable& table, const FrameAnimation& frame, uint32_t width, uint32_t height, uint32_t tilesX,
+                uint32_t tilesY, std::vector<uint16_t>& masks) {
+    masks.assign(size_t(tilesX) * tilesY, 0);
+    const LetterOffset* offsets = frame.offsets;
+
+    // uv = (2 * fragCoord - iResolution) / iResolution.y * uScale, turned around into pixels. The wobble
+    // only turns a letter about its origin, so a circle of the glyph reach covers it at any angle
+    float pixelsPerUnit = height / (2.0f * frame.uScale);
+    float radius = glyphReach() * pixelsPerUnit + 1.0f;     // A pixel of slack for fragCoord being a centre
+    for (size_t letter = 0; letter < table.letters.size(); letter++) {
+        float cx = width * 0.5f - offsets[letter].x * pixelsPerUnit;
+        float cy = height * 0.5f - offsets[letter].y * pixelsPerUnit;
+        float minX = std::floor((cx - radius) / LETTER_TILE_SIZE);
+        float maxX = std::floor((cx + radius) / LETTER_TILE_SIZE);
+        float minY = std::floor((cy - radius) / LETTER_TILE_SIZE);
+        float maxY = std::floor((cy + radius) / LETTER_TILE_SIZE);
+        if ((maxX < 0.0f) || (maxY < 0.0f) || (minX >= tilesX) || (minY >= tilesY)) {
+            continue;                       // Still spiralling in from off screen
+        }
+
+        uint16_t bit = static_cast<uint16_t>(1u << letter);
+        uint32_t firstX = static_cast<uint32_t>(std::max(minX, 0.0f));
+        uint32_t lastX = static_cast<uint32_t>(std::min(maxX, tilesX - 1.0f));
+        uint32_t firstY = static_cast<uint32_t>(std::max(minY, 0.0f));
+        uint32_t lastY = static_cast<uint32_t>(std::min(maxY, tilesY - 1.0f));
+        for (uint32_t ty = firstY; ty <= lastY; ty++) {
+            for (uint32_t tx = firstX; tx <= lastX; tx++) {
+                // Closest point of the tile to the letter's origin
+                float dx = cx - clamp(cx, float(tx * LETTER_TILE_SIZE), float((tx + 1) * LETTER_TILE_SIZE));
+                float dy = cy - clamp(cy, float(ty * LETTER_TILE_SIZE), float((ty + 1) * LETTER_TILE_SIZE));
+                if (dx * dx + dy * dy <= radius * radius) {
+                    masks[ty * tilesX + tx] |= bit;
+                }
+            }
+        }
+    }
+} // binLetters
+
+/***************************** LetterTiles *****************************/
+
+LetterTiles::~LetterTiles() {
+    destroy();
+}
+
+void LetterTiles::destroy() {
+    if (texture) {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+    tilesX = tilesY = 0;
+}
+
+bool LetterTiles::create() {
+    glGenTextures(1, &texture);
+    glActiveTexture(GL_TEXTURE0 + LETTER_TILES_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    // Integer textures can only be sampled with NEAREST
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glActiveTexture(GL_TEXTURE0);
+    glyphReach();                           // Measured once, here rather than in the first frame
+    return texture != 0;
+}
+
+void LetterTiles::update(const LetterTable& table, const FrameAnimation& frame, uint32_t width, uint32_t height) {
+    uint32_t columns = (width + LETTER_TILE_SIZE - 1) / LETTER_TILE_SIZE;
+    uint32_t rows = (height + LETTER_TILE_SIZE - 1) / LETTER_TILE_SIZE;
+    binLetters(table, frame, width, height, columns, rows, masks);
+
+    uint32_t letters = 0;
+    for (uint16_t mask : masks) {
+        for (uint16_t bits = mask; bits; bits &= bits - 1) {
+            letters++;
+        }
+    }
+    lettersPerTile = masks.empty() ? 0.0f : float(letters) / masks.size();
+
+    glActiveTexture(GL_TEXTURE0 + LETTER_TILES_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);      // Rows are an odd number of 16 bit masks as often as not
+    if ((columns != tilesX) || (rows != tilesY)) {
+        tilesX = columns;
+        tilesY = rows;
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, tilesX, tilesY, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, masks.data());
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, tilesX, tilesY, GL_RED_INTEGER, GL_UNSIGNED_SHORT, masks.data());
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void LetterTiles::bind() const {
+    glActiveTexture(GL_TEXTURE0 + LETTER_TILES_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void LetterTiles::bindSampler(const ShaderProgram& program) {
+    program.setSampler("uLetterTiles", LETTER_TILES_TEXTURE_UNIT);
+}
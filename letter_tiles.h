@@ -0,0 +1,67 @@
+/*******************************************************************
+    Birthday Shader 2025 - per-tile letter culling
+
+    Most of the screen is background, yet every pixel used to run all
+    thirteen letter blocks. Each frame the CPU works out where every
+    letter can draw (its origin from the frame's animation and a reach
+    that covers the glyph, its shadow and any wobble) and marks the
+    screen tiles each one overlaps. The marks go up as a small texture
+    of per-tile letter bitmasks and the shader, with LETTER_TILES
+    defined, skips the blocks whose bit is clear. Skipped letters would
+    have mixed in exactly zero, so the image does not change.
+*******************************************************************/
+#ifndef LETTER_TILES_H
+#define LETTER_TILES_H
+
+#include "animation.h"
+#include "shader_program.h"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <vector>
+
+constexpr uint32_t LETTER_TILE_SIZE = 32;       // Pixels; LETTER_TILE_SIZE in birthday.shader must match
+constexpr GLint LETTER_TILES_TEXTURE_UNIT = 2;  // After the upscale pass (0) and the letter atlas (1)
+
+// Lines for insertDefines(): LETTER_TILES when culling, nothing otherwise
+const char* letterTileDefines(bool culling);
+
+// Bit i of a tile's mask is set when letter i of the table may touch the tile
+void binLetters(const LetterTable& table, const FrameAnimation& frame, uint32_t width, uint32_t height, uint32_t tilesX,
+                uint32_t tilesY, std::vector<uint16_t>& masks);
+
+class LetterTiles {
+public:
+    LetterTiles() = default;
+    ~LetterTiles();
+
+    LetterTiles(const LetterTiles&) = delete;
+    LetterTiles& operator=(const LetterTiles&) = delete;
+
+    // Needs a current context
+    bool create();
+    void destroy();
+
+    // Bin the frame about to be drawn at width x height (iResolution) and upload the masks
+    void update(const LetterTable& table, const FrameAnimation& frame, uint32_t width, uint32_t height);
+
+    // Bind the texture to LETTER_TILES_TEXTURE_UNIT again, after other GL code may have used the unit
+    void bind() const;
+
+    // Point the program's uLetterTiles sampler at the tile unit, with the program in use (harmless for
+    // programs without it)
+    static void bindSampler(const ShaderProgram& program);
+
+    // Average letters per tile in the last update, out of the table's letters
+    float averageLetters() const { return lettersPerTile; }
+
+private:
+    GLuint texture = 0;
+    uint32_t tilesX = 0;
+    uint32_t tilesY = 0;
+    std::vector<uint16_t> masks;
+    float lettersPerTile = 0.0f;
+};
+
+#endif // LETTER_TILES_H
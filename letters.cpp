@@ -0,0 +1,166 @@
+/*******************************************************************
+    Birthday Shader 2025 - letter table and per-frame placement
+*******************************************************************/
+#include "letters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+const char glyphOrder[] = "ABDHIPRTY";      // GLYPH_A ... GLYPH_Y in letters.glsl
+
+bool parseFloat(const std::string& text, float& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtof(text.c_str(), &end);
+    return *end == '\0';
+}
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, separator)) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+// amplitude:wave[:spiralPower[:rampStart:rampRate:rampPower]]
+bool parseTerm(const std::string& text, LetterTerm& term) {
+    std::vector<std::string> fields = split(text, ':');
+    if ((fields.size() != 2) && (fields.size() != 3) && (fields.size() != 6)) {
+        return false;
+    }
+    term.spiralPower = 1.0f;
+    term.rampStart = term.rampRate = term.rampPower = 0.0f;
+    if (fields[1] == "sin") {
+        term.wave = WAVE_SIN;
+    } else if (fields[1] == "cos") {
+        term.wave = WAVE_COS;
+    } else if (fields[1] == "cossin") {
+        term.wave = WAVE_COS_SIN;
+    } else if (fields[1] == "1") {
+        term.wave = WAVE_NONE;
+    } else {
+        return false;
+    }
+    return parseFloat(fields[0], term.amplitude) &&
+        ((fields.size() < 3) || parseFloat(fields[2], term.spiralPower)) &&
+        ((fields.size() < 6) || (parseFloat(fields[3], term.rampStart) && parseFloat(fields[4], term.rampRate) &&
+                                 parseFloat(fields[5], term.rampPower)));
+}
+
+// In the order the hand-written shader blocks used to work it out per pixel
+float evaluateTerm(const LetterTerm& term, float iTime, float angle, float spiral) {
+    float value = (term.spiralPower == 1.0f) ? spiral : std::pow(spiral, term.spiralPower);
+    if (term.amplitude != 1.0f) {
+        value *= term.amplitude;
+    }
+    if (term.rampPower != 0.0f) {
+        float ramp = std::max(0.0f, term.rampStart + term.rampRate * iTime);
+        value *= (term.rampPower == 1.0f) ? ramp : std::pow(ramp, term.rampPower);
+    }
+    switch (term.wave) {
+    case WAVE_SIN:      return value * std::sin(angle);
+    case WAVE_COS:      return value * std::cos(angle);
+    case WAVE_COS_SIN:  return value * std::cos(angle) * std::sin(angle);
+    default:            return value;
+    }
+}
+
+} // namespace
+
+bool parseLetterTable(const std::string& text, const std::string& name, LetterTable& table, std::string& error) {
+    LetterTable parsed;
+    std::stringstream stream(text);
+    std::string line;
+    for (int lineNumber = 1; std::getline(stream, line); lineNumber++) {
+        line = line.substr(0, line.find('#'));
+        std::stringstream fields(line);
+        std::string glyph, x, y, row, speed, decay, dx, dy, color, extra;
+        if (!(fields >> glyph)) {
+            continue;                       // Blank or comment
+        }
+
+        std::string where = name + ":" + std::to_string(lineNumber) + ": ";
+        if (!(fields >> x >> y >> row >> speed >> decay >> dx >> dy >> color) || (fields >> extra)) {
+            error = where + "expected glyph x y row speed decay dx dy color";
+            return false;
+        }
+        LetterSpec letter;
+        if ((glyph.size() != 1) || (glyphIndex(glyph[0]) < 0)) {
+            error = where + "no glyph '" + glyph + "' (there are A B D H I P R T Y)";
+            return false;
+        }
+        letter.glyph = glyph[0];
+        if (!parseFloat(x, letter.x) || !parseFloat(y, letter.y) || !parseFloat(speed, letter.speed) ||
+            !parseFloat(decay, letter.decay)) {
+            error = where + "bad number";
+            return false;
+        }
+        if ((row != "top") && (row != "bottom")) {
+            error = where + "row is top or bottom, not '" + row + "'";
+            return false;
+        }
+        letter.bottomRow = (row == "bottom");
+        if (!parseTerm(dx, letter.dx) || !parseTerm(dy, letter.dy)) {
+            error = where + "bad spiral term (amplitude:wave[:spiralPower[:rampStart:rampRate:rampPower]])";
+            return false;
+        }
+        std::vector<std::string> rgb = split(color, ',');
+        if ((rgb.size() != 3) || !parseFloat(rgb[0], letter.color[0]) || !parseFloat(rgb[1], letter.color[1]) ||
+            !parseFloat(rgb[2], letter.color[2])) {
+            error = where + "color is r,g,b";
+            return false;
+        }
+        if (parsed.letters.size() == LETTER_MAX) {
+            error = where + "more than " + std::to_string(LETTER_MAX) + " letters";
+            return false;
+        }
+        parsed.letters.push_back(letter);
+    }
+    if (parsed.letters.empty()) {
+        error = name + ": no letters";
+        return false;
+    }
+    table = parsed;
+    return true;
+} // parseLetterTable
+
+bool loadLetterTable(const std::string& path, LetterTable& table, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "Failed to open letter table: " + path;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return parseLetterTable(buffer.str(), path, table, error);
+}
+
+int glyphIndex(char glyph) {
+    const char* found = std::find(glyphOrder, glyphOrder + GLYPH_COUNT, glyph);
+    return (found == glyphOrder + GLYPH_COUNT) ? -1 : static_cast<int>(found - glyphOrder);
+}
+
+void computeLetterOffsets(const LetterTable& table, float iTime, LetterOffset offsets[LETTER_MAX]) {
+    for (size_t i = 0; i < table.letters.size(); i++) {
+        const LetterSpec& letter = table.letters[i];
+        float angle = iTime * letter.speed;
+        float spiral = std::exp(-letter.decay * iTime);
+        // SETUP_LETTER(uv.x - x, uv.y - y, ...) with the spiral increment added on top
+        offsets[i].x = -letter.x + evaluateTerm(letter.dx, iTime, angle, spiral);
+        offsets[i].y = -letter.y + evaluateTerm(letter.dy, iTime, angle, spiral);
+    }
+}
+
+float letterWobble(float iTime) {
+    return std::sin(iTime * 4.0f) * .1f;
+}
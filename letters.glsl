@@ -0,0 +1,167 @@
+/***************************** 'Letterbox' ;-) functions *****************************/
+
+// Based on code from https://www.shadertoy.com/view/3sByD1
+
+MP float sdBox(MP vec2 p, MP vec2 b)
+{
+    MP vec2 d = H(abs(H(p)) - b);
+    return H(length(max(d, 0.)) + min(max(d.x, d.y), 0.));
+}
+
+float sdA(vec2 uv, float ah, float al, float t, bool inner)
+{
+    uv *= uWobble;
+ 	float a = 0.;
+    a = S(ah, al, sdBox(vec2(uv.x + .1, uv.y) * rot(PI * .08), vec2(t, .25 + t)));
+    a += S(ah, al, sdBox(vec2(uv.x - .1, uv.y) * rot(-PI * .08), vec2(t, .25 + t)));
+    a += S(ah, al, sdBox(vec2(uv.x, uv.y + .05), vec2(.1, t * .8)));
+    a = min(a, S(ah, al, sdBox(uv, vec2(.26, .26))));
+    if(inner)
+    	a = min(a, S(ah, al, sdBox(uv, vec2(.26, .25))));
+    return a;
+}
+
+float sdB(vec2 uv, float ah, float al, float t, float inner)
+{
+    uv *= uWobble;
+    float b = S(ah, al, sdBox(vec2(uv.x + .12, uv.y), vec2(t, .2 + t)));
+    b += S(ah, al, abs(sdBox(vec2(uv.x+t+inner, uv.y-.12), vec2(.1, .0001))-.09)-t*.9);
+    b += S(ah, al, abs(sdBox(vec2(uv.x+t+inner, uv.y+.12), vec2(.1, .0001))-.09)-t*.9);
+    b = min(b, S(ah, al, sdBox(vec2(uv.x - .04, uv.y), vec2(.22, .28))));
+    if (inner > 0.)
+        b = min(b, S(ah, al, sdBox(vec2(uv.x - .0435, uv.y), vec2(.21, .28))));
+    return b; 
+}
+
+float sdD(vec2 uv, float ah, float al, float t, float inner)
+{
+    uv *= uWobble;
+	float d = S(ah, al, sdBox(vec2(uv.x + .12, uv.y), vec2(t, .2 + t)));
+    d += S(ah, al, abs(sdBox(vec2(uv.x+t+inner+.06, uv.y), vec2(.1, .0001))-.202)-t);
+    d = min(d, S(ah, al, sdBox(vec2(uv.x - .04, uv.y), vec2(.22, .28))));
+    if (inner > 0.)
+        d = min(d, S(ah, al, sdBox(vec2(uv.x - .07, uv.y), vec2(.236, .26))));
+    return d;
+}
+
+float sdH(vec2 uv, float ah, float al, float t)
+{
+    uv *= uWobble;
+	float h = 0.;
+    h = S(ah, al, sdBox(vec2(uv.x + .12, uv.y), vec2(t, .2 + t)));
+    h += S(ah, al, sdBox(vec2(uv.x - .12, uv.y), vec2(t, .2 + t)));
+    h += S(ah, al, sdBox(uv, vec2(.1, t)));
+    return h;
+}
+
+float sdI(vec2 uv, float ah, float al, float t)
+{
+    uv *= uWobble;
+    return S(ah, al, sdBox(uv, vec2(t, .2 + t)));
+}
+
+float sdP(vec2 uv, float ah, float al, float t, float inner)
+{
+    uv *= uWobble;
+    float p = S(ah, al, sdBox(vec2(uv.x + .12, uv.y), vec2(t, .2 + t)));
+    p += S(ah, al, abs(sdBox(vec2(uv.x+t+inner, uv.y-.106), vec2(.1, .0001))-.1)-t);
+    p = min(p, S(ah, al, sdBox(vec2(uv.x - .04, uv.y), vec2(.22, .28))));
+    if (inner > 0.)
+        p = min(p, S(ah, al, sdBox(vec2(uv.x - .043, uv.y), vec2(.21, .28))));
+    return p;
+}
+
+float sdR(vec2 uv, float ah, float al, float t, float inner)
+{
+    uv *= uWobble;
+    float r = S(ah, al, sdBox(vec2(uv.x + .12, uv.y), vec2(t, .2 + t)));
+    r += S(ah, al, abs(sdBox(vec2(uv.x+t+inner, uv.y-.106), vec2(.1, .0001))-.1)-t);
+    r += S(ah, al, sdBox(vec2(uv.x - .1, uv.y + .18) * rot(-PI * .2), vec2(t, .2)));
+    r = min(r, S(ah, al, sdBox(vec2(uv.x - .04, uv.y - .02), vec2(.22, .28))));
+    if (inner > 0.)
+        r = min(r, S(ah, al, sdBox(vec2(uv.x-.04, uv.y-.02-inner), vec2(.207, .28))));
+    return r;
+}
+
+float sdT(vec2 uv, float ah, float al, float t, bool inner)
+{
+    uv *= uWobble;
+	float tt = S(ah, al, sdBox(vec2(uv.x, uv.y + .03), vec2(t, .23)));
+    tt += S(ah, al, sdBox(vec2(uv.x, uv.y - .2), vec2(.23, t)));
+    if(inner)
+        tt = min(tt, S(ah, al, sdBox(uv, vec2(.22, .25))));
+    return tt;
+}
+
+float sdY(vec2 uv, float ah, float al, float t, bool inner)
+{
+    uv *= uWobble;
+    float y = S(ah, al, sdBox(vec2(uv.x, uv.y + .14), vec2(t, .12)));
+    y += S(ah, al, sdBox(vec2(uv.x + .1, uv.y - .14) * rot(PI * .86), vec2(t, .24)));
+    y += S(ah, al, sdBox(vec2(uv.x - .1, uv.y - .14) * rot(-PI * .86), vec2(t, .24)));
+    y = min(y, S(ah, al, sdBox(vec2(uv.x, uv.y + .2), vec2(.45))));
+    if (inner)
+        y = min(y, S(ah, al, sdBox(vec2(uv.x, uv.y + .005), vec2(.3, .245))));
+    return y;
+}
+
+/***************************** Letter atlas *****************************/
+
+// --letters atlas defines LETTER_ATLAS: each letter becomes one lookup into distances baked by
+// letter_atlas.cpp (.x shadow, .y outline, .z fill) instead of three calls of the functions above.
+// The layers are in this order
+#define GLYPH_A 0
+#define GLYPH_B 1
+#define GLYPH_D 2
+#define GLYPH_H 3
+#define GLYPH_I 4
+#define GLYPH_P 5
+#define GLYPH_R 6
+#define GLYPH_T 7
+#define GLYPH_Y 8
+#define LETTER_EXTENT .75
+
+// The layers a letter is drawn in, each of which --profile can leave out
+#ifdef ABLATE_SHADOW
+#define SHADOW_LAYER(STATEMENT)
+#else
+#define SHADOW_LAYER(STATEMENT) STATEMENT
+#endif
+#ifdef ABLATE_OUTLINE
+#define OUTLINE_LAYER(STATEMENT)
+#else
+#define OUTLINE_LAYER(STATEMENT) STATEMENT
+#endif
+#ifdef ABLATE_FILL
+#define FILL_LAYER(STATEMENT)
+#else
+#define FILL_LAYER(STATEMENT) STATEMENT
+#endif
+
+#ifdef LETTER_ATLAS
+uniform sampler2DArray uLetterAtlas;
+
+// Shadow smoothstep edges per glyph; the outline and fill all use (.015, .005)
+const vec2 shadowEdges[9] = vec2[9](vec2(.05, -.05), vec2(.06, -.06), vec2(.06, -.06), vec2(.06, -.05),
+                                    vec2(.06, -.06), vec2(.06, -.06), vec2(.06, -.06), vec2(.06, -.06),
+                                    vec2(.05, -.05));
+
+vec3 letterDistances(vec2 uv, int glyph)
+{
+    // Beyond the baked square the distance carries on from its edge
+    vec2 q = clamp(uv, -LETTER_EXTENT, LETTER_EXTENT);
+    vec3 d = textureLod(uLetterAtlas, vec3(q / (2. * LETTER_EXTENT) + .5, float(glyph)), 0.).xyz;
+    return d + length(uv - q);
+}
+
+#define DRAW_LETTER(GLYPH, FILL_COLOR, SHADOW, OUTLINE, FILL) { \
+    vec3 d = letterDistances(st * uWobble, GLYPH); \
+    SHADOW_LAYER(col = H(mix(col, shadow, shadowStr * S(shadowEdges[GLYPH].x, shadowEdges[GLYPH].y, d.x)));) \
+    OUTLINE_LAYER(col = H(mix(col, white, S(.015, .005, d.y)));) \
+    FILL_LAYER(col = H(mix(col, FILL_COLOR, S(.015, .005, d.z)));) }
+#else
+#define DRAW_LETTER(GLYPH, FILL_COLOR, SHADOW, OUTLINE, FILL) { \
+    SHADOW_LAYER(col = H(mix(col, shadow, shadowStr * SHADOW));) \
+    OUTLINE_LAYER(col = H(mix(col, white, OUTLINE));) \
+    FILL_LAYER(col = H(mix(col, FILL_COLOR, FILL));) }
+#endif
@@ -0,0 +1,72 @@
+/*******************************************************************
+    Birthday Shader 2025 - letter table and per-frame placement
+
+    The message is a table (birthday.letters), one row per letter:
+    which glyph, where it comes to rest, the row it sits in and how it
+    spirals in. Every letter is drawn in its own frame st = uv + offset,
+    where the offset starts far away and settles on the rest position.
+    The same table drives the shader (letter_shader.h), the tile culling
+    and the CPU renderer.
+*******************************************************************/
+#ifndef LETTERS_H
+#define LETTERS_H
+
+#include <string>
+#include <vector>
+
+constexpr int LETTER_MAX = 16;              // One bit each in the 16 bit tile masks of letter_tiles.h
+constexpr int GLYPH_COUNT = 9;
+
+// How a spiral term swings with the angle
+enum LetterWave {
+    WAVE_NONE,
+    WAVE_SIN,
+    WAVE_COS,
+    WAVE_COS_SIN                            // cos(angle) * sin(angle)
+};
+
+// One component of the spiral offset:
+//  amplitude * pow(spiral, spiralPower) * pow(max(0, rampStart + rampRate * iTime), rampPower) * wave(angle)
+// A rampPower of 0 leaves the ramp out
+struct LetterTerm {
+    float amplitude;
+    LetterWave wave;
+    float spiralPower;
+    float rampStart;
+    float rampRate;
+    float rampPower;
+};
+
+struct LetterSpec {
+    char glyph;                             // One of A B D H I P R T Y
+    float x, y;                             // Rest position in uv units
+    bool bottomRow;                         // Fill gradient of the bottom row (botGrad) instead of the top
+    float speed;                            // angle = iTime * speed
+    float decay;                            // spiral = exp(-decay * iTime)
+    LetterTerm dx, dy;
+    float color[3];
+};
+
+struct LetterTable {
+    std::vector<LetterSpec> letters;        // In drawing order, later letters on top
+};
+
+struct LetterOffset {
+    float x;
+    float y;
+};
+
+// Read a table in the birthday.letters format. On failure error says which line and why
+bool loadLetterTable(const std::string& path, LetterTable& table, std::string& error);
+bool parseLetterTable(const std::string& text, const std::string& name, LetterTable& table, std::string& error);
+
+// Index of a glyph in the GLYPH_ order of letters.glsl (A B D H I P R T Y), -1 if there is none
+int glyphIndex(char glyph);
+
+// Offsets for every letter of the table, in table order
+void computeLetterOffsets(const LetterTable& table, float iTime, LetterOffset offsets[LETTER_MAX]);
+
+// Rotation angle every letter function applies to its frame: sin(iTime * 4.) * .1
+float letterWobble(float iTime);
+
+#endif // LETTERS_H
@@ -0,0 +1,413 @@
+/*******************************************************************
+    Birthday Shader 2025 - one render, every display
+*******************************************************************/
+#include "mirror.h"
+#include "gl_common.h"
+#include "headless.h"
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const char* mirrorWindowTitle = "Happy Birthday Sam!";
+
+bool replayRequested = false;               // Space in any window
+
+// GL_TIME_ELAPSED around one step of every frame, in the context current when it was created. A query
+// is only read back MIRROR_QUERY_COUNT frames later, so the CPU never waits on a GPU that has drained
+class QueryRing {
+public:
+    void create() { glGenQueries(MIRROR_QUERY_COUNT, queries); }
+    void destroy() { glDeleteQueries(MIRROR_QUERY_COUNT, queries); }
+
+    void begin() {
+        if (issued - collected >= MIRROR_QUERY_COUNT) {
+            collect();
+        }
+        glBeginQuery(GL_TIME_ELAPSED, queries[issued % MIRROR_QUERY_COUNT]);
+    }
+    void end() {
+        glEndQuery(GL_TIME_ELAPSED);
+        issued++;
+    }
+
+    // Read back the queries still in flight
+    void finish() {
+        while (collected != issued) {
+            collect();
+        }
+    }
+    double meanMilliseconds() const { return collected ? totalMilliseconds / collected : 0.0; }
+
+private:
+    void collect() {
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(queries[collected % MIRROR_QUERY_COUNT], GL_QUERY_RESULT, &elapsed);
+        totalMilliseconds += elapsed / 1.0e6;
+        collected++;
+    }
+
+    GLuint queries[MIRROR_QUERY_COUNT] = {};
+    uint32_t issued = 0;
+    uint32_t collected = 0;
+    double totalMilliseconds = 0.0;
+};
+
+// A display's window. The first one's context draws the frame, and every context blits it
+struct MirrorWindow {
+    GLFWwindow* window = nullptr;
+    MirrorRegion region;
+    int framebufferWidth = 0;               // Larger than the region on high-DPI screens
+    int framebufferHeight = 0;
+    int swapInterval = 0;
+    GLuint readFramebuffer = 0;             // The frame texture in this context; the frame's own in the first
+    GLint blitRect[4] = {};                 // x0, y0, x1, y1 the frame is stretched to
+    QueryRing blits;
+    double presentSeconds = 0.0;            // CPU over the timed frames: switching to the context, blit and swap
+};
+
+// The largest rectangle of the frame's aspect that fits in the window, centred
+void fitFrame(uint32_t frameWidth, uint32_t frameHeight, MirrorWindow& mirror) {
+    double scale = std::min(double(mirror.framebufferWidth) / frameWidth,
+                            double(mirror.framebufferHeight) / frameHeight);
+    GLint width = static_cast<GLint>(frameWidth * scale + 0.5);
+    GLint height = static_cast<GLint>(frameHeight * scale + 0.5);
+    mirror.blitRect[0] = (mirror.framebufferWidth - width) / 2;
+    mirror.blitRect[1] = (mirror.framebufferHeight - height) / 2;
+    mirror.blitRect[2] = mirror.blitRect[0] + width;
+    mirror.blitRect[3] = mirror.blitRect[1] + height;
+}
+
+std::vector<MirrorRegion> monitorRegions() {
+    std::vector<MirrorRegion> regions;
+    int count = 0;
+    GLFWmonitor** monitors = glfwGetMonitors(&count);
+    for (int i = 0; i < count; i++) {
+        const GLFWvidmode* mode = glfwGetVideoMode(monitors[i]);
+        if (!mode) {
+            continue;
+        }
+        MirrorRegion region;
+        glfwGetMonitorPos(monitors[i], &region.x, &region.y);
+        region.width = static_cast<uint32_t>(mode->width);
+        region.height = static_cast<uint32_t>(mode->height);
+        regions.push_back(region);
+    }
+    return regions;
+}
+
+void mirrorKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (action != GLFW_PRESS) {
+        return;
+    }
+    if ((key == GLFW_KEY_Q) || (key == GLFW_KEY_ESCAPE)) {
+        glfwSetWindowShouldClose(window, 1);
+    } else if (key == GLFW_KEY_SPACE) {
+        replayRequested = true;
+    }
+}
+
+bool anyWindowClosed(const std::vector<MirrorWindow>& windows) {
+    for (const MirrorWindow& mirror : windows) {
+        if (glfwWindowShouldClose(mirror.window)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// GPU milliseconds per frame of the scene on its own at width x height, over MIRROR_SWEEP_FRAMES spread over
+// the timeline. Every size is timed after the other, as --bench times its combinations
+double sweepMilliseconds(Scene& scene, float endTime, uint32_t width, uint32_t height) {
+    OffscreenTarget target;
+    if (!target.create(width, height)) {
+        return 0.0;
+    }
+    target.bind();
+    for (uint32_t frame = 0; frame < MIRROR_QUERY_COUNT; frame++) {
+        scene.render(0.0f, width, height);
+    }
+    QueryRing queries;
+    queries.create();
+    for (uint32_t frame = 0; frame < MIRROR_SWEEP_FRAMES; frame++) {
+        queries.begin();
+        scene.render(endTime * frame / MIRROR_SWEEP_FRAMES, width, height);
+        queries.end();
+    }
+    queries.finish();
+    queries.destroy();
+    return queries.meanMilliseconds();
+}
+
+void printReport(const std::string& renderer, const std::vector<MirrorWindow>& windows, const OffscreenTarget& frame,
+                 const QueryRing& renders, uint32_t timedFrames, double seconds, double mirrored,
+                 const std::vector<double>& separate) {
+    char line[256];
+    std::cout << "GL_RENDERER: " << renderer << std::endl;
+    snprintf(line, sizeof(line), "%u frames timed in %.3g s (%.1f fps), drawn once at %ux%u for %zu windows:",
+             timedFrames, seconds, (seconds > 0.0) ? timedFrames / seconds : 0.0, frame.width, frame.height,
+             windows.size());
+    std::cout << line << std::endl;
+    snprintf(line, sizeof(line), "%-8s %-24s %5s %12s %12s", "window", "region", "swap", "blit GPU ms", "present ms");
+    std::cout << line << std::endl;
+
+    double blits = 0.0;
+    for (size_t i = 0; i < windows.size(); i++) {
+        const MirrorWindow& mirror = windows[i];
+        char region[64];
+        snprintf(region, sizeof(region), "%ux%u%+d%+d", mirror.region.width, mirror.region.height, mirror.region.x,
+                 mirror.region.y);
+        snprintf(line, sizeof(line), "%-8zu %-24s %5d %12.3f %12.3f", i, region, mirror.swapInterval,
+                 mirror.blits.meanMilliseconds(), timedFrames ? 1000.0 * mirror.presentSeconds / timedFrames : 0.0);
+        std::cout << line << std::endl;
+        blits += mirror.blits.meanMilliseconds();
+    }
+    snprintf(line, sizeof(line), "GPU ms per frame: render %.3f + blits %.3f = %.3f", renders.meanMilliseconds(),
+             blits, renders.meanMilliseconds() + blits);
+    std::cout << line << std::endl;
+
+    // The comparison is timed over the same sweep for both, whatever part of the timeline the windows showed
+    double processes = 0.0;
+    for (double milliseconds : separate) {
+        processes += milliseconds;
+    }
+    snprintf(line, sizeof(line), "Over the timeline (%u frames): mirrored %.3f GPU ms per frame, %zu processes %.3f "
+             "(%.2fx)", MIRROR_SWEEP_FRAMES, mirrored + blits, windows.size(), processes,
+             (mirrored + blits > 0.0) ? processes / (mirrored + blits) : 0.0);
+    std::cout << line << std::endl;
+} // printReport
+
+} // namespace
+
+bool parseMirrorRegions(const char* text, std::vector<MirrorRegion>& regions) {
+    if (std::string(text) == "monitors") {
+        regions.clear();
+        return true;
+    }
+    std::vector<MirrorRegion> parsed;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        unsigned w = 0, h = 0;
+        int x = 0, y = 0;
+        char end = 0;
+        if ((sscanf(item.c_str(), "%ux%u%d%d%c", &w, &h, &x, &y, &end) != 4) || (w == 0) || (h == 0)) {
+            return false;
+        }
+        parsed.push_back({ x, y, w, h });
+    }
+    if (parsed.empty()) {
+        return false;
+    }
+    regions = parsed;
+    return true;
+}
+
+bool parseSwapIntervals(const char* text, std::vector<int>& intervals) {
+    std::vector<int> parsed;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        int interval = 0;
+        char end = 0;
+        if ((sscanf(item.c_str(), "%d%c", &interval, &end) != 1) || (interval < 0)) {
+            return false;
+        }
+        parsed.push_back(interval);
+    }
+    if (parsed.empty()) {
+        return false;
+    }
+    intervals = parsed;
+    return true;
+}
+
+int runMirrorMode(const MirrorOptions& options) {
+    if (!glfwInit()) {
+        std::cerr << "Failed to initialize GLFW" << std::endl;
+        return -1;
+    }
+    std::vector<MirrorRegion> regions = options.regions.empty() ? monitorRegions() : options.regions;
+    if (regions.empty()) {
+        std::cerr << "No monitors to mirror to" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    // Borderless windows covering their regions, all sharing the first one's objects
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_DECORATED, GLFW_FALSE);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);  // Shown once it is in place
+    std::vector<MirrorWindow> windows(regions.size());
+    for (size_t i = 0; i < windows.size(); i++) {
+        MirrorWindow& mirror = windows[i];
+        mirror.region = regions[i];
+        mirror.swapInterval = options.swapIntervals[std::min(i, options.swapIntervals.size() - 1)];
+        mirror.window = glfwCreateWindow(mirror.region.width, mirror.region.height, mirrorWindowTitle, nullptr,
+                                         i ? windows[0].window : nullptr);
+        if (!mirror.window) {
+            std::cerr << "Failed to create GLFW window " << i << std::endl;
+            glfwTerminate();
+            return -1;
+        }
+        glfwSetWindowPos(mirror.window, mirror.region.x, mirror.region.y);
+        glfwSetKeyCallback(mirror.window, mirrorKeyCallback);
+        glfwShowWindow(mirror.window);
+        glfwGetFramebufferSize(mirror.window, &mirror.framebufferWidth, &mirror.framebufferHeight);
+    }
+
+    glfwMakeContextCurrent(windows[0].window);
+    if (!initGLEW()) {
+        std::cerr << "Failed to initialize GLEW" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    std::string renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+
+    // The frame is drawn at the size of the window with the most pixels
+    const MirrorWindow* largest = &windows[0];
+    for (const MirrorWindow& mirror : windows) {
+        if (int64_t(mirror.framebufferWidth) * mirror.framebufferHeight >
+            int64_t(largest->framebufferWidth) * largest->framebufferHeight) {
+            largest = &mirror;
+        }
+    }
+    std::string shaderSource = loadShaderSource(options.shaderPath);
+    Scene scene;
+    std::string error;
+    if (!scene.create(options.scene, shaderSource, std::cout, error)) {
+        std::cerr << error << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    scene.setRandom(options.uRandom);
+    OffscreenTarget frame;
+    if (!frame.create(std::max(1, largest->framebufferWidth), std::max(1, largest->framebufferHeight))) {
+        std::cerr << "Failed to create " << frame.width << "x" << frame.height << " framebuffer" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    QueryRing renders;
+    renders.create();
+
+    // Framebuffers aren't shared between contexts, so every other one reads the frame texture through its own
+    for (size_t i = 0; i < windows.size(); i++) {
+        MirrorWindow& mirror = windows[i];
+        glfwMakeContextCurrent(mirror.window);
+        glfwSwapInterval(mirror.swapInterval);
+        if (i == 0) {
+            mirror.readFramebuffer = frame.framebuffer;
+        } else {
+            glGenFramebuffers(1, &mirror.readFramebuffer);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, mirror.readFramebuffer);
+            glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, frame.colorTexture, 0);
+        }
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        mirror.blits.create();
+        fitFrame(frame.width, frame.height, mirror);
+    }
+
+    std::cout << "Mirroring to " << windows.size() << " windows; in any of them press Space to replay, Q or Escape "
+        "to stop" << std::endl;
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point timingStart = Clock::now();
+    double animationStart = glfwGetTime();
+    uint32_t frameCount = 0;
+    while (!anyWindowClosed(windows)) {
+        glfwPollEvents();
+        if (replayRequested) {
+            replayRequested = false;
+            animationStart = glfwGetTime();
+        }
+        float time = static_cast<float>(glfwGetTime() - animationStart);
+
+        // The first frames warm the driver up, and llvmpipe's first query in a context has no start time
+        bool timed = (frameCount >= MIRROR_WARMUP_FRAMES);
+        if (frameCount == MIRROR_WARMUP_FRAMES) {
+            timingStart = Clock::now();
+        }
+        glfwMakeContextCurrent(windows[0].window);
+        frame.bind();
+        if (timed) {
+            renders.begin();
+        }
+        scene.render(time, frame.width, frame.height);
+        if (timed) {
+            renders.end();
+        }
+
+        // The other contexts see the frame once what drew it is flushed, and their blits wait for it on the GPU
+        GLsync drawn = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+        for (size_t i = 0; i < windows.size(); i++) {
+            MirrorWindow& mirror = windows[i];
+            Clock::time_point presentStart = Clock::now();
+            if (i > 0) {
+                glfwMakeContextCurrent(mirror.window);
+                glWaitSync(drawn, 0, GL_TIMEOUT_IGNORED);
+            }
+            if (timed) {
+                mirror.blits.begin();
+            }
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, mirror.readFramebuffer);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glBlitFramebuffer(0, 0, frame.width, frame.height, mirror.blitRect[0], mirror.blitRect[1],
+                              mirror.blitRect[2], mirror.blitRect[3], GL_COLOR_BUFFER_BIT, GL_LINEAR);
+            if (timed) {
+                mirror.blits.end();
+            }
+            glfwSwapBuffers(mirror.window);
+            if (timed) {
+                mirror.presentSeconds += std::chrono::duration<double>(Clock::now() - presentStart).count();
+            }
+        }
+        glDeleteSync(drawn);
+        frameCount++;
+    }
+    uint32_t timedFrames = (frameCount > MIRROR_WARMUP_FRAMES) ? frameCount - MIRROR_WARMUP_FRAMES : 0;
+    double seconds = timedFrames ? std::chrono::duration<double>(Clock::now() - timingStart).count() : 0.0;
+    for (size_t i = windows.size(); i-- > 0;) {
+        glfwMakeContextCurrent(windows[i].window);
+        windows[i].blits.finish();
+    }
+    renders.finish();
+
+    // What the frame costs drawn once, against every window drawing its own
+    std::cerr << "mirror: timing the scene at every window's size" << std::endl;
+    float endTime = options.scene.timeline.end();
+    double mirrored = sweepMilliseconds(scene, endTime, frame.width, frame.height);
+    std::vector<double> separate;
+    for (const MirrorWindow& mirror : windows) {
+        separate.push_back(sweepMilliseconds(scene, endTime, std::max(1, mirror.framebufferWidth),
+                                             std::max(1, mirror.framebufferHeight)));
+    }
+    printReport(renderer, windows, frame, renders, timedFrames, seconds, mirrored, separate);
+
+    for (size_t i = windows.size(); i-- > 0;) {
+        glfwMakeContextCurrent(windows[i].window);
+        windows[i].blits.destroy();
+        if (i > 0) {
+            glDeleteFramebuffers(1, &windows[i].readFramebuffer);
+        }
+    }
+    renders.destroy();
+    frame.destroy();
+    scene.destroy();
+    for (size_t i = windows.size(); i-- > 0;) {
+        glfwDestroyWindow(windows[i].window);
+    }
+    glfwTerminate();
+    return 0;
+} // runMirrorMode
@@ -0,0 +1,58 @@
+/*******************************************************************
+    Birthday Shader 2025 - one render, every display
+
+    Venue installs drive several displays, and one process per display
+    runs the whole fragment shader once for each of them. --mirror
+    renders every frame once instead, into a texture, and blits it to
+    a window on every monitor (or on every region of the desktop it is
+    given). The windows' contexts share the texture with the first
+    one's, which draws the scene. A fence orders each blit after the
+    render. Every window keeps its own swap interval: with vsync on all
+    of them a frame would wait for one vblank per window, so by default
+    only the first waits. The frame is drawn at the size of the
+    largest window and letterboxed into the others.
+
+    On exit it reports what presenting costs every window, its blit on
+    the GPU and the CPU time of switching to it, blitting and swapping,
+    and compares the GPU time of a frame with that of N processes,
+    timing the scene at each window's size over the same iTime sweep.
+*******************************************************************/
+#ifndef MIRROR_H
+#define MIRROR_H
+
+#include "scene.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+constexpr uint32_t MIRROR_WARMUP_FRAMES = 10;  // Shown before the windows' costs are timed
+constexpr uint32_t MIRROR_QUERY_COUNT = 4;     // Timer queries in flight per context before the CPU waits on one
+constexpr uint32_t MIRROR_SWEEP_FRAMES = 60;   // Frames over the timeline each size is timed for in the comparison
+
+// A window's place on the desktop, in screen coordinates
+struct MirrorRegion {
+    int x;
+    int y;
+    uint32_t width;
+    uint32_t height;
+};
+
+struct MirrorOptions {
+    std::vector<MirrorRegion> regions;      // One window each; one per monitor if empty
+    std::vector<int> swapIntervals;         // Window by window, the last one for the rest
+    float uRandom;
+    std::string shaderPath;                 // Built-in shader if empty
+    SceneOptions scene;
+};
+
+// Parse "monitors" (regions left empty) or "1920x1080+0+0,1920x1080+1920+0,..."
+bool parseMirrorRegions(const char* text, std::vector<MirrorRegion>& regions);
+
+// Parse "1,0,..."
+bool parseSwapIntervals(const char* text, std::vector<int>& intervals);
+
+// --mirror: draw the animation once a frame and show it in every window until one is closed
+int runMirrorMode(const MirrorOptions& options);
+
+#endif // MIRROR_H
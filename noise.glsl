@@ -0,0 +1,32 @@
+/***************************** Noise *****************************/
+
+// Gradient noise, based on code from https://www.shadertoy.com/view/wdyczG
+
+// With NOISE_TEXTURE defined (the background pass, background_layer.cpp) noise() reads a baked
+// table of the NOISE_CELLS lattice cells along x from uNoiseOrigin on instead of hashing
+#define NOISE_CELLS 64.
+#ifdef NOISE_TEXTURE
+uniform sampler2D uNoise;
+uniform float uNoiseOrigin;
+#endif
+
+vec2 hash(vec2 p) {
+    p = vec2( dot(p,vec2(2127.1,81.17)), dot(p,vec2(1269.5,283.37)) );
+	return fract(sin(p)*43758.5453);
+}
+
+MP float noise(vec2 p) {
+#ifdef NOISE_TEXTURE
+    // Rows cover p.y in [-.25, .25], all uv.x * uv.y can reach
+    return texture(uNoise, vec2((p.x - uNoiseOrigin) / NOISE_CELLS, p.y * 2. + .5)).r;
+#else
+    vec2 i = floor(p);
+    MP vec2 f = H(fract(p));
+	MP vec2 u = H(f*f*(3.0-2.0*f));
+    MP float n = H(mix( mix( dot( -1.0+2.0*hash( i + vec2(0.0,0.0) ), f - vec2(0.0,0.0) ), 
+                        dot( -1.0+2.0*hash( i + vec2(1.0,0.0) ), f - vec2(1.0,0.0) ), u.x),
+                   mix( dot( -1.0+2.0*hash( i + vec2(0.0,1.0) ), f - vec2(0.0,1.0) ), 
+                        dot( -1.0+2.0*hash( i + vec2(1.0,1.0) ), f - vec2(1.0,1.0) ), u.x), u.y));
+	return H(0.5 + 0.5*n);
+#endif
+}
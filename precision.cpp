@@ -0,0 +1,34 @@
+/*******************************************************************
+    Birthday Shader 2025 - shader precision tiers
+*******************************************************************/
+#include "precision.h"
+
+#include <cstring>
+
+namespace {
+
+const char* precisionNames[] = { "high", "medium", "half" };
+
+} // namespace
+
+bool parseShaderPrecision(const char* name, ShaderPrecision& precision) {
+    for (int i = 0; i < 3; i++) {
+        if (strcmp(name, precisionNames[i]) == 0) {
+            precision = static_cast<ShaderPrecision>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* shaderPrecisionName(ShaderPrecision precision) {
+    return precisionNames[precision];
+}
+
+const char* precisionShaderDefines(ShaderPrecision precision) {
+    switch (precision) {
+    case PRECISION_MEDIUM: return "#define PRECISION_MEDIUM\n";
+    case PRECISION_HALF: return "#define PRECISION_HALF\n";
+    default: return "";
+    }
+}
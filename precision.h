@@ -0,0 +1,32 @@
+/*******************************************************************
+    Birthday Shader 2025 - shader precision tiers
+
+    Most of what the fragment shader computes ends up as an 8-bit
+    colour, and GPUs with 16-bit ALUs run mediump math at up to twice
+    the rate. --precision medium declares the hot paths mediump:
+    sdBox(), rot(), noise()'s interpolation and the smoothstep
+    compositing, everything but hash(), whose fract(sin(p)*43758.5453)
+    needs every bit of highp. Desktop OpenGL accepts the qualifiers
+    and computes in full precision regardless, so --precision half
+    rounds those same values to half floats in the shader, to show
+    what medium would look like where it takes effect. --bench
+    --precision all times the three and measures medium and half
+    against high. The background layer's own pass stays at high.
+*******************************************************************/
+#ifndef PRECISION_H
+#define PRECISION_H
+
+enum ShaderPrecision {
+    PRECISION_HIGH,                         // highp everywhere (the original)
+    PRECISION_MEDIUM,                       // PRECISION_MEDIUM: hot paths declared mediump
+    PRECISION_HALF                          // PRECISION_HALF: mediump, with the values rounded to half floats
+};
+constexpr ShaderPrecision PRECISION_DEFAULT = PRECISION_HIGH;
+
+bool parseShaderPrecision(const char* name, ShaderPrecision& precision);
+const char* shaderPrecisionName(ShaderPrecision precision);
+
+// Lines for insertDefines()
+const char* precisionShaderDefines(ShaderPrecision precision);
+
+#endif // PRECISION_H
@@ -0,0 +1,194 @@
+/*******************************************************************
+    Birthday Shader 2025 - per-section GPU cost
+*******************************************************************/
+#include "profile.h"
+#include "gl_common.h"
+#include "headless.h"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+// The shader built with everything, or with one section left out
+struct Variant {
+    std::string name;
+    std::string defines;                    // ABLATE_ lines, empty for everything
+    bool background;                        // Renders the background layer's pass, when the scene has one
+    std::vector<double> gpu;                // Milliseconds of every frame, in sweep order
+};
+
+Variant makeVariant(const std::string& name, const std::string& defines, bool background = true) {
+    Variant variant;
+    variant.name = name;
+    variant.defines = defines;
+    variant.background = background;
+    return variant;
+}
+
+std::vector<Variant> variantsFor(const LetterTable& message) {
+    std::vector<Variant> variants;
+    variants.push_back(makeVariant("everything", ""));
+    variants.push_back(makeVariant("background", "#define ABLATE_BACKGROUND\n", false));
+    char name[32];
+    char defines[64];
+    for (size_t i = 0; i < message.letters.size(); i++) {
+        snprintf(name, sizeof(name), "letter %zu (%c)", i, message.letters[i].glyph);
+        snprintf(defines, sizeof(defines), "#define ABLATE_LETTERS 0x%xu\n", 1u << i);
+        variants.push_back(makeVariant(name, defines));
+    }
+    variants.push_back(makeVariant("shadows", "#define ABLATE_SHADOW\n"));
+    variants.push_back(makeVariant("outlines", "#define ABLATE_OUTLINE\n"));
+    variants.push_back(makeVariant("fills", "#define ABLATE_FILL\n"));
+    return variants;
+}
+
+// Mean of the frames in [first, last)
+double meanOf(const std::vector<double>& values, size_t first, size_t last) {
+    double sum = 0.0;
+    for (size_t i = first; i < last; i++) {
+        sum += values[i];
+    }
+    return (last > first) ? sum / (last - first) : 0.0;
+}
+
+// Section costs ranked, most expensive first: the whole sweep, then each phase
+void printTable(const ProfileOptions& options, const std::vector<Variant>& variants, uint32_t frameCount) {
+    std::vector<size_t> phaseStart;
+    for (uint32_t phase = 0; phase <= PROFILE_PHASES; phase++) {
+        phaseStart.push_back(size_t(frameCount) * phase / PROFILE_PHASES);
+    }
+    const std::vector<double>& everything = variants[0].gpu;
+    double whole = meanOf(everything, 0, frameCount);
+
+    struct Row {
+        const Variant* variant;
+        double cost;
+    };
+    std::vector<Row> rows;
+    for (size_t i = 1; i < variants.size(); i++) {
+        rows.push_back({ &variants[i], whole - meanOf(variants[i].gpu, 0, frameCount) });
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.cost > b.cost; });
+
+    char line[256];
+    int length = snprintf(line, sizeof(line), "%-18s %9s %7s", "section", "ms", "share");
+    for (uint32_t phase = 0; phase < PROFILE_PHASES; phase++) {
+        char range[32];
+        snprintf(range, sizeof(range), "%.3g-%.3gs", options.startTime + phaseStart[phase] / options.fps,
+                 options.startTime + phaseStart[phase + 1] / options.fps);
+        length += snprintf(line + length, sizeof(line) - length, " %11s", range);
+    }
+    std::cout << line << std::endl;
+
+    auto printRow = [&](const char* name, double cost, const std::vector<double>* frames) {
+        int length = snprintf(line, sizeof(line), "%-18s %9.3f %6.1f%%", name, cost,
+                              (whole > 0.0) ? 100.0 * cost / whole : 0.0);
+        for (uint32_t phase = 0; phase < PROFILE_PHASES; phase++) {
+            if (phaseStart[phase] == phaseStart[phase + 1]) {
+                length += snprintf(line + length, sizeof(line) - length, " %11s", "-");     // Fewer frames than phases
+                continue;
+            }
+            double phaseCost = meanOf(everything, phaseStart[phase], phaseStart[phase + 1]);
+            if (frames) {
+                phaseCost -= meanOf(*frames, phaseStart[phase], phaseStart[phase + 1]);
+            }
+            length += snprintf(line + length, sizeof(line) - length, " %11.3f", phaseCost);
+        }
+        std::cout << line << std::endl;
+    };
+    printRow("whole frame", whole, nullptr);
+    for (const Row& row : rows) {
+        printRow(row.variant->name.c_str(), row.cost, &row.variant->gpu);
+    }
+} // printTable
+
+} // namespace
+
+int runProfileMode(const ProfileOptions& options) {
+    HeadlessContext context;
+    std::string error;
+    if (!context.create(error)) {
+        std::cerr << "Failed to create headless OpenGL context: " << error << std::endl;
+        return -1;
+    }
+    if (!initGLEW()) {
+        std::cerr << "Failed to initialize GLEW" << std::endl;
+        return -1;
+    }
+    std::string renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+
+    OffscreenTarget target;
+    if (!target.create(options.width, options.height)) {
+        std::cerr << "Failed to create " << options.width << "x" << options.height << " framebuffer" << std::endl;
+        return -1;
+    }
+    target.bind();
+
+    std::string shaderSource = loadShaderSource(options.shaderPath);
+    std::vector<Variant> variants = variantsFor(options.scene.message);
+    uint32_t frameCount = static_cast<uint32_t>(std::max(1.0, std::ceil(double(options.endTime - options.startTime) * options.fps)));
+    GLuint queries[PROFILE_QUERY_COUNT];
+    glGenQueries(PROFILE_QUERY_COUNT, queries);
+
+    // One variant after another over the whole sweep, as --bench times its combinations
+    for (Variant& variant : variants) {
+        SceneOptions sceneOptions = options.scene;
+        sceneOptions.ablation = variant.defines;
+        Scene scene;
+        if (!scene.create(sceneOptions, shaderSource, std::cerr, error)) {
+            std::cerr << variant.name << ": " << error << std::endl;
+            return -1;
+        }
+        scene.setRandom(options.uRandom);
+        target.bind();
+
+        auto drawFrame = [&](float time) {
+            scene.update(time, options.width, options.height);
+            if (variant.background) {
+                scene.renderBackground();
+            }
+            scene.draw();
+        };
+        for (uint32_t frame = 0; frame < PROFILE_WARMUP_FRAMES; frame++) {
+            drawFrame(options.startTime);
+        }
+        glFinish();
+
+        // A query is only read back PROFILE_QUERY_COUNT frames later, so the GPU never drains between frames
+        auto collectQuery = [&](uint32_t frame) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(queries[frame % PROFILE_QUERY_COUNT], GL_QUERY_RESULT, &elapsed);
+            variant.gpu.push_back(elapsed / 1.0e6);
+        };
+        for (uint32_t frame = 0; frame < frameCount; frame++) {
+            if (frame >= PROFILE_QUERY_COUNT) {
+                collectQuery(frame - PROFILE_QUERY_COUNT);
+            }
+            glBeginQuery(GL_TIME_ELAPSED, queries[frame % PROFILE_QUERY_COUNT]);
+            drawFrame(options.startTime + static_cast<float>(frame) / options.fps);
+            glEndQuery(GL_TIME_ELAPSED);
+            glFlush();
+        }
+        for (uint32_t frame = (frameCount > PROFILE_QUERY_COUNT) ? frameCount - PROFILE_QUERY_COUNT : 0;
+             frame < frameCount; frame++) {
+            collectQuery(frame);
+        }
+        std::cerr << "profile: " << (variant.defines.empty() ? "" : "without ") << variant.name << ", "
+                  << meanOf(variant.gpu, 0, frameCount) << " ms" << std::endl;
+    }
+    glDeleteQueries(PROFILE_QUERY_COUNT, queries);
+
+    char number[64];
+    snprintf(number, sizeof(number), "%.6g to %.6g s at 1/%.6g", options.startTime, options.endTime, options.fps);
+    std::cout << "GL_RENDERER: " << renderer << std::endl;
+    std::cout << "GPU ms per frame at " << options.width << "x" << options.height << ", iTime " << number << " ("
+              << frameCount << " frames), and what each section adds to it:" << std::endl;
+    printTable(options, variants, frameCount);
+    return 0;
+} // runProfileMode
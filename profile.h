@@ -0,0 +1,41 @@
+/*******************************************************************
+    Birthday Shader 2025 - per-section GPU cost
+
+    The whole effect is one fragment shader, so a GPU profiler sees a
+    single draw. --profile builds it again with one section left out
+    at a time: the background, each letter of the table, and the
+    shadow, outline and fill layers of every letter (the ABLATE_
+    defines of birthday.shader), and renders each one through EGL over
+    the same fixed iTime sweep and uRandom, timing every frame with
+    GL_TIME_ELAPSED. A section costs what the frame saves without it.
+    The table is ranked by that cost over the whole sweep, with a
+    column for each part of it, to show how the costs move while the
+    letters spiral in and settle.
+*******************************************************************/
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "scene.h"
+
+#include <cstdint>
+#include <string>
+
+constexpr uint32_t PROFILE_WARMUP_FRAMES = 10;     // Of every variant at the first iTime, before timing
+constexpr uint32_t PROFILE_QUERY_COUNT = 4;        // Timer queries in flight per variant before the CPU waits on one
+constexpr uint32_t PROFILE_PHASES = 4;             // Columns the sweep is split into
+
+struct ProfileOptions {
+    uint32_t width;
+    uint32_t height;
+    float startTime;                        // Frames are rendered for iTime in [startTime, endTime)
+    float endTime;
+    float fps;                              // iTime step is 1 / fps
+    float uRandom;
+    std::string shaderPath;                 // Built-in shader if empty
+    SceneOptions scene;                     // What every variant is built with, less its section
+};
+
+// --profile: time the shader without each section and print the ranked cost table
+int runProfileMode(const ProfileOptions& options);
+
+#endif // PROFILE_H
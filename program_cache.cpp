@@ -0,0 +1,333 @@
+/*******************************************************************
+    Birthday Shader 2025 - program binary cache
+*******************************************************************/
+#include "program_cache.h"
+#include "gl_common.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <sys/stat.h>
+#if defined(_WIN32)
+#include <direct.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr uint32_t CACHE_MAGIC = 0x42505342;    // "BSPB"
+constexpr uint32_t CACHE_VERSION = 1;
+constexpr uint32_t CACHE_MAX_BINARY = 64u << 20; // Bytes; a length past this is a damaged header, not a program
+constexpr size_t STARTUP_LOG_LINES = 1000;      // Programs startup.log records before it is trimmed
+constexpr size_t STARTUP_LOG_KEEP = 500;        // The latest lines a trim keeps; entries none of them used go
+
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t format;                        // binaryFormat from glGetProgramBinary
+    uint32_t length;
+};
+
+const char* sourceNames[] = { "hit", "miss", "rejected", "unavailable" };
+
+bool makeDirectory(const std::string& path) {
+#if defined(_WIN32)
+    int result = _mkdir(path.c_str());
+#else
+    int result = mkdir(path.c_str(), 0755);
+#endif
+    struct stat info;
+    return (result == 0) || ((stat(path.c_str(), &info) == 0) && (info.st_mode & S_IFDIR));
+}
+
+// FNV-1a, 64 bit
+void hashBytes(uint64_t& hash, const char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ull;
+    }
+}
+
+void hashString(uint64_t& hash, const char* text) {
+    // Include the terminator so "ab" + "c" and "a" + "bc" differ
+    hashBytes(hash, text ? text : "", text ? strlen(text) + 1 : 1);
+}
+
+bool binaryFormatsAvailable() {
+    if (!GLEW_ARB_get_program_binary) {
+        return false;
+    }
+    int formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+std::string entryPath(const std::string& directory, const std::string& key) {
+    return directory + "/program-" + key + ".bin";
+}
+
+// The driver part of the key on its own, recorded in startup.log so entries of an earlier driver can go
+std::string driverKey() {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hashString(hash, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+    hashString(hash, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    hashString(hash, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    char key[17];
+    snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+    return key;
+}
+
+// Other instances may be starting at the same moment: files are written privately, then renamed into place
+std::string temporaryPath(const std::string& path) {
+#if defined(_WIN32)
+    return path + "." + std::to_string(_getpid()) + ".tmp";
+#else
+    return path + "." + std::to_string(getpid()) + ".tmp";
+#endif
+}
+
+void replaceFile(const std::string& temporary, const std::string& path) {
+#if defined(_WIN32)
+    remove(path.c_str());                   // rename() doesn't replace on Windows
+#endif
+    if (rename(temporary.c_str(), path.c_str()) != 0) {
+        remove(temporary.c_str());
+    }
+}
+
+GLuint loadBinary(const std::string& path, bool& rejected) {
+    rejected = false;
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return 0;
+    }
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    CacheHeader header;
+    std::vector<char> binary;
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) && (header.magic == CACHE_MAGIC) &&
+        (header.version == CACHE_VERSION) && (header.length <= CACHE_MAX_BINARY) &&
+        (static_cast<std::streamoff>(header.length) == size - static_cast<std::streamoff>(sizeof(header)))) {
+        binary.resize(header.length);
+        file.read(binary.data(), binary.size());
+    }
+    if (binary.empty() || !file) {
+        rejected = true;
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    int success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        rejected = true;
+        return 0;
+    }
+    return program;
+}
+
+void storeBinary(const std::string& path, GLuint program) {
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+    CacheHeader header = { CACHE_MAGIC, CACHE_VERSION, format, static_cast<uint32_t>(length) };
+
+    std::string temporary = temporaryPath(path);
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), length);
+        if (!file) {
+            file.close();
+            remove(temporary.c_str());
+            return;
+        }
+    }
+    replaceFile(temporary, path);
+}
+
+// A startup.log line: time, how the program was had, milliseconds, key, driver key (absent in older lines)
+void parseStartupLine(const std::string& line, std::string& key, std::string& driver) {
+    std::istringstream fields(line);
+    std::string time, source, milliseconds;
+    key.clear();
+    driver.clear();
+    fields >> time >> source >> milliseconds >> key >> driver;
+}
+
+// Keep the latest STARTUP_LOG_KEEP lines of the current driver and delete the entries of every other key in
+// the log: they belong to an earlier driver, or to a source nothing has built for that many programs. A line
+// another instance appends while this runs may be lost, which only makes its entry a candidate sooner
+void trimStartupLog(const std::string& directory, const std::vector<std::string>& lines, const std::string& driver) {
+    std::vector<std::string> kept;
+    std::set<std::string> keptKeys;
+    std::string key, lineDriver;
+    for (size_t i = lines.size(); (i-- > 0) && (kept.size() < STARTUP_LOG_KEEP); ) {
+        parseStartupLine(lines[i], key, lineDriver);
+        if (lineDriver == driver) {
+            kept.push_back(lines[i]);
+            keptKeys.insert(key);
+        }
+    }
+    for (const std::string& line : lines) {
+        parseStartupLine(line, key, lineDriver);
+        if (!key.empty() && !keptKeys.count(key)) {
+            remove(entryPath(directory, key).c_str());
+        }
+    }
+
+    std::string path = directory + "/startup.log";
+    std::string temporary = temporaryPath(path);
+    {
+        std::ofstream file(temporary);
+        for (size_t i = kept.size(); i-- > 0; ) {
+            file << kept[i] << "\n";
+        }
+        if (!file) {
+            file.close();
+            remove(temporary.c_str());
+            return;
+        }
+    }
+    replaceFile(temporary, path);
+}
+
+void recordStartup(const std::string& directory, ProgramSource source, double milliseconds, const std::string& key) {
+    if (directory.empty()) {
+        return;
+    }
+    std::string path = directory + "/startup.log";
+    std::string driver = driverKey();
+    char entry[128];
+    snprintf(entry, sizeof(entry), "%lld %s %.3f %s %s", static_cast<long long>(time(nullptr)), sourceNames[source],
+             milliseconds, key.c_str(), driver.c_str());
+
+    // Appended as a rule; trimmed once it is long or a line is from another driver
+    std::vector<std::string> lines;
+    bool otherDriver = false;
+    {
+        std::ifstream file(path);
+        std::string lineKey, lineDriver;
+        for (std::string line; std::getline(file, line); ) {
+            parseStartupLine(line, lineKey, lineDriver);
+            otherDriver = otherDriver || (lineDriver != driver);
+            lines.push_back(line);
+        }
+    }
+    lines.push_back(entry);
+    if (otherDriver || (lines.size() > STARTUP_LOG_LINES)) {
+        trimStartupLog(directory, lines, driver);
+        return;
+    }
+    FILE* file = fopen(path.c_str(), "a");
+    if (file) {
+        fprintf(file, "%s\n", entry);
+        fclose(file);
+    }
+}
+
+} // namespace
+
+std::string programCacheDirectory() {
+    std::string base;
+#if defined(_WIN32)
+    const char* localAppData = getenv("LOCALAPPDATA");
+    if (localAppData) {
+        base = localAppData;
+    }
+#elif defined(__APPLE__)
+    const char* home = getenv("HOME");
+    if (home) {
+        base = std::string(home) + "/Library/Caches";
+    }
+#else
+    const char* cacheHome = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+    if (cacheHome && *cacheHome) {
+        base = cacheHome;
+    } else if (home) {
+        base = std::string(home) + "/.cache";
+        makeDirectory(base);
+    }
+#endif
+    if (base.empty()) {
+        return "";
+    }
+    std::string directory = base + "/birthdayshader";
+    return makeDirectory(directory) ? directory : "";
+}
+
+std::string programCacheKey(const char* vertexSource, const std::string& fragmentSource) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hashString(hash, vertexSource);
+    hashString(hash, fragmentSource.c_str());
+    hashString(hash, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+    hashString(hash, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    hashString(hash, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    char key[17];
+    snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+    return key;
+}
+
+GLuint loadOrBuildProgram(const char* vertexSource, GLuint vertexShader, const std::string& fragmentSource,
+                          GLuint& fragmentShader, std::ostream& log, std::string& error) {
+    auto start = std::chrono::steady_clock::now();
+    fragmentShader = 0;
+
+    std::string directory = binaryFormatsAvailable() ? programCacheDirectory() : "";
+    std::string key = programCacheKey(vertexSource, fragmentSource);
+    ProgramSource source = PROGRAM_CACHE_UNAVAILABLE;
+    GLuint program = 0;
+    if (!directory.empty()) {
+        bool rejected = false;
+        program = loadBinary(entryPath(directory, key), rejected);
+        source = program ? PROGRAM_CACHE_HIT : (rejected ? PROGRAM_CACHE_REJECTED : PROGRAM_CACHE_MISS);
+        if (rejected) {
+            remove(entryPath(directory, key).c_str());
+        }
+    }
+
+    if (!program) {
+        fragmentShader = buildShader(GL_FRAGMENT_SHADER, fragmentSource.c_str(), error);
+        if (!fragmentShader) {
+            return 0;
+        }
+        program = linkProgram(vertexShader, fragmentShader);
+        std::string linkLog;
+        if (!programLinked(program, linkLog)) {
+            error = "Shader program failed to link:\n" + linkLog;
+            glDeleteProgram(program);
+            glDeleteShader(fragmentShader);
+            fragmentShader = 0;
+            return 0;
+        }
+        if (!directory.empty()) {
+            storeBinary(entryPath(directory, key), program);
+        }
+    }
+
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    recordStartup(directory, source, milliseconds, key);
+    char line[96];
+    snprintf(line, sizeof(line), "Shader program: cache %s, ready in %.1f ms", sourceNames[source], milliseconds);
+    log << line << std::endl;
+    return program;
+} // loadOrBuildProgram
@@ -0,0 +1,44 @@
+/*******************************************************************
+    Birthday Shader 2025 - program binary cache
+
+    Keeps the linked shader program on disk (glGetProgramBinary) so
+    later launches skip compiling the fragment shader. Entries are
+    keyed by a hash of both shader sources and the GL vendor, renderer
+    and version strings, so editing the shader or updating the driver
+    simply misses. A binary the driver refuses, or one whose header
+    doesn't match the file, is deleted and rebuilt.
+    Every startup appends its path and time to startup.log in the
+    cache directory, which is where the hit rate can be read from.
+    The log doubles as the cache's index: past 1000 lines, or once
+    the driver changes, it is cut to the latest 500 of this driver
+    and the entries no remaining line names are deleted, so shader
+    edits and driver updates don't pile up files forever.
+*******************************************************************/
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <GL/glew.h>
+
+#include <ostream>
+#include <string>
+
+enum ProgramSource {
+    PROGRAM_CACHE_HIT,                      // Loaded with glProgramBinary
+    PROGRAM_CACHE_MISS,                     // Compiled, then stored
+    PROGRAM_CACHE_REJECTED,                 // Binary found but refused by the driver, compiled again
+    PROGRAM_CACHE_UNAVAILABLE               // Driver has no binary formats or no cache directory
+};
+
+// Per-user cache directory, created on first use; empty when there is nowhere to write
+std::string programCacheDirectory();
+
+// Needs a current context: the driver strings are part of the key
+std::string programCacheKey(const char* vertexSource, const std::string& fragmentSource);
+
+// Link vertexShader with fragmentSource, or load the binary of an identical earlier build.
+// fragmentShader is 0 on a cache hit. Prints the startup path and how long it took to log.
+// 0 when fragmentSource doesn't compile or the program doesn't link, with the info log in error
+GLuint loadOrBuildProgram(const char* vertexSource, GLuint vertexShader, const std::string& fragmentSource,
+                          GLuint& fragmentShader, std::ostream& log, std::string& error);
+
+#endif // PROGRAM_CACHE_H
@@ -0,0 +1,166 @@
+/*******************************************************************
+    Birthday Shader 2025 - the scene
+*******************************************************************/
+#include "scene.h"
+#include "embedded_files.h"
+#include "gl_common.h"
+#include "program_cache.h"
+
+#include <random>
+
+bool loadSceneContent(const std::string& messagePath, const std::string& timelinePath, LetterTable& message,
+                      Timeline& timeline, std::string& error) {
+    std::string text;
+    error = "birthday.letters was not built in";
+    bool messageLoaded = messagePath.empty() ?
+        (embeddedFile("birthday.letters", text) && parseLetterTable(text, "birthday.letters", message, error)) :
+        loadLetterTable(messagePath, message, error);
+    if (!messageLoaded) {
+        return false;
+    }
+    error = "birthday.timeline was not built in";
+    return timelinePath.empty() ?
+        (embeddedFile("birthday.timeline", text) && parseTimeline(text, "birthday.timeline", timeline, error)) :
+        loadTimeline(timelinePath, timeline, error);
+}
+
+float seedRandom(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    return dist(rng);
+}
+
+Scene::~Scene() {
+    destroy();
+}
+
+bool Scene::create(const SceneOptions& options, const std::string& shaderSource, std::ostream& log, std::string& error,
+                   Tracer* tracer) {
+    destroy();
+    settings = options;
+    defines = letterTableDefines(settings.message, settings.letterCode) + letterShaderDefines(settings.letters) +
+        letterTileDefines(settings.letterCulling) + backgroundShaderDefines(settings.background) +
+        antialiasShaderDefines(settings.antialias) + precisionShaderDefines(settings.precision) + settings.ablation;
+
+    TraceSpan vertexSpan(tracer, "compile vertex shader");
+    vertexShader = buildShader(GL_VERTEX_SHADER, vertexShaderSource, error);
+    vertexSpan.finish();
+    if (!vertexShader) {
+        return false;
+    }
+
+    TraceSpan programSpan(tracer, "compile + link fragment shader (or program cache)");
+    program.reset(loadOrBuildProgram(vertexShaderSource, vertexShader, insertDefines(shaderSource, defines),
+                                     fragmentShader, log, error));
+    programSpan.finish();
+    if (!program.id()) {
+        return false;
+    }
+
+    animationBlock.create();
+    if (settings.letters == LETTERS_ATLAS) {
+        TraceSpan span(tracer, "bake letter atlas");
+        atlas.create();
+    }
+    if (settings.letterCulling) {
+        tiles.create();
+    }
+    if (backgroundLayer()) {
+        TraceSpan span(tracer, "build background pass");
+        if (!background.create(shaderSource, vertexShader, settings.backgroundScale, log, error)) {
+            error = "Background pass failed to build: " + error;
+            return false;
+        }
+    }
+    setupProgram();
+
+    createFullscreenQuad(vao, vbo);
+    return true;
+} // create
+
+void Scene::destroy() {
+    if (vao) {
+        glDeleteBuffers(1, &vbo);
+        glDeleteVertexArrays(1, &vao);
+        vao = vbo = 0;
+    }
+    animationBlock.destroy();
+    atlas.destroy();
+    tiles.destroy();
+    background.destroy();
+    program.destroy();
+    if (vertexShader) {
+        glDeleteShader(vertexShader);
+        vertexShader = 0;
+    }
+    if (fragmentShader) {
+        glDeleteShader(fragmentShader);
+        fragmentShader = 0;
+    }
+}
+
+// Everything a new program needs once: the letter table and where its block and samplers find their buffer
+// and textures
+void Scene::setupProgram() {
+    program.use();
+    setLetterUniforms(program, settings.message);
+    AnimationBlock::bindBlock(program);
+    LetterAtlas::bindSampler(program);
+    LetterTiles::bindSampler(program);
+    BackgroundLayer::bindSampler(program);
+}
+
+void Scene::setRandom(float value) {
+    uRandom = value;
+    animationBlock.setRandom(uRandom);
+}
+
+void Scene::update(float iTime, uint32_t frameWidth, uint32_t frameHeight) {
+    time = iTime;
+    width = frameWidth;
+    height = frameHeight;
+    FrameAnimation animation;
+    animateFrame(settings.timeline, settings.message, time, animation);
+    animationBlock.setFrame(animation, time, width, height);
+    animationBlock.upload();
+    if (settings.letterCulling) {
+        tiles.update(settings.message, animation, width, height);
+    }
+}
+
+void Scene::renderBackground() {
+    if (backgroundLayer()) {
+        background.render(width, height, time, uRandom);
+    }
+}
+
+void Scene::draw() {
+    // The quad covers every pixel of the viewport, so nothing is cleared first; a clear would also reach past
+    // the viewport into the rest of an embedding application's framebuffer
+    program.use();
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+void Scene::render(float iTime, uint32_t frameWidth, uint32_t frameHeight) {
+    update(iTime, frameWidth, frameHeight);
+    renderBackground();
+    draw();
+}
+
+void Scene::replaceProgram(GLuint newProgram) {
+    program.reset(newProgram);
+    setupProgram();
+}
+
+bool Scene::rebuildBackground(const std::string& shaderSource, std::string& error) {
+    return !backgroundLayer() || background.rebuild(shaderSource, error);
+}
+
+void Scene::bind() {
+    program.use();
+    glBindVertexArray(vao);
+    animationBlock.bind();
+    atlas.bind();
+    tiles.bind();
+    background.bind();
+}
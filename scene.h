@@ -0,0 +1,111 @@
+/*******************************************************************
+    Birthday Shader 2025 - the scene
+
+    Everything it takes to draw the effect into a framebuffer, whoever
+    owns the context: the main program built for the chosen letter
+    code, letter mode, culling, background, anti-aliasing and
+    precision, the Animation block, the letter atlas and tiles, the
+    background layer and the full-screen quad. The window, --headless, --batch and the
+    C API of birthday_renderer.h all draw through it. It keeps no
+    global state, so every context can have a scene of its own.
+*******************************************************************/
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "animation.h"
+#include "animation_block.h"
+#include "antialias.h"
+#include "background_layer.h"
+#include "letter_atlas.h"
+#include "letter_shader.h"
+#include "letter_tiles.h"
+#include "precision.h"
+#include "shader_program.h"
+#include "trace.h"
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// How the scene is drawn; what --letter-code, --letters, --no-cull, --background, --aa and --precision pick
+struct SceneOptions {
+    LetterTable message;
+    Timeline timeline;
+    LetterCode letterCode = LETTER_CODE_DEFAULT;
+    LetterMode letters = LETTERS_DEFAULT;
+    bool letterCulling = true;              // Skip letters per screen tile (letter_tiles.h)
+    BackgroundMode background = BACKGROUND_DEFAULT;
+    float backgroundScale = BACKGROUND_DEFAULT_SCALE;
+    AntialiasMode antialias = ANTIALIAS_DEFAULT;
+    ShaderPrecision precision = PRECISION_DEFAULT;
+    std::string ablation;                   // ABLATE_ defines leaving a section out (profile.h); empty for none
+};
+
+// The message and the timeline: the copies built in, or the files where a path is given
+bool loadSceneContent(const std::string& messagePath, const std::string& timelinePath, LetterTable& message,
+                      Timeline& timeline, std::string& error);
+
+// uRandom for a seed, the first number --seed would draw
+float seedRandom(uint32_t seed);
+
+class Scene {
+public:
+    Scene() = default;
+    ~Scene();
+
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+
+    // Needs a current context with GLEW loaded. shaderSource is birthday.shader as loaded, without defines.
+    // Leaves the program in use and the quad bound. Startup steps go into tracer when there is one
+    bool create(const SceneOptions& options, const std::string& shaderSource, std::ostream& log, std::string& error,
+                Tracer* tracer = nullptr);
+    void destroy();
+
+    void setRandom(float value);
+    float random() const { return uRandom; }
+
+    // A frame, in three steps so each can be timed on its own: the uniforms, Animation block and letter tiles
+    // for iTime at width x height; the background layer's pass, if there is one; and the main pass into the
+    // framebuffer and viewport the caller has bound
+    void update(float iTime, uint32_t width, uint32_t height);
+    void renderBackground();
+    void draw();
+
+    // All three at once
+    void render(float iTime, uint32_t width, uint32_t height);
+
+    // Hot reload: switch to program, built with shaderDefines(), and delete the one it replaces
+    void replaceProgram(GLuint newProgram);
+    bool backgroundLayer() const { return settings.background == BACKGROUND_LAYER; }
+    bool rebuildBackground(const std::string& shaderSource, std::string& error);
+
+    // Make the program, quad, textures and Animation block current again, after other GL code ran in between
+    void bind();
+
+    const std::string& shaderDefines() const { return defines; }
+    GLuint vertex() const { return vertexShader; }
+
+private:
+    void setupProgram();
+
+    SceneOptions settings;
+    std::string defines;                    // What the main program was built with
+    GLuint vertexShader = 0;
+    GLuint fragmentShader = 0;              // 0 when the program came from the cache
+    ShaderProgram program;
+    float uRandom = 0.0f;
+    float time = 0.0f;                      // Of the frame update() was last given
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    AnimationBlock animationBlock;
+    LetterAtlas atlas;
+    LetterTiles tiles;
+    BackgroundLayer background;
+};
+
+#endif // SCENE_H
@@ -0,0 +1,78 @@
+/*******************************************************************
+    Birthday Shader 2025 - #include for shader files
+*******************************************************************/
+#include "shader_include.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+std::string directoryOf(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return (slash == std::string::npos) ? "" : path.substr(0, slash + 1);
+}
+
+// The file name of a line `#include "name"`, or false for any other line
+bool includeName(const std::string& line, std::string& name) {
+    size_t hash = line.find_first_not_of(" \t");
+    if ((hash == std::string::npos) || (line.compare(hash, 8, "#include") != 0)) {
+        return false;
+    }
+    size_t open = line.find('"', hash + 8);
+    size_t close = (open == std::string::npos) ? open : line.find('"', open + 1);
+    if (close == std::string::npos) {
+        name.clear();                       // Malformed; reported by the caller
+        return true;
+    }
+    name = line.substr(open + 1, close - open - 1);
+    return true;
+}
+
+bool expand(const std::string& path, std::vector<std::string>& stack, std::string& source, std::string& error,
+            std::vector<std::string>* files) {
+    if (std::find(stack.begin(), stack.end(), path) != stack.end()) {
+        error = path + " includes itself";
+        return false;
+    }
+    if (stack.size() >= static_cast<size_t>(SHADER_INCLUDE_MAX_DEPTH)) {
+        error = "Includes nested too deeply at " + path;
+        return false;
+    }
+    std::ifstream file(path);
+    if (!file) {
+        error = "Failed to open shader file: " + path;
+        return false;
+    }
+    if (files) {
+        files->push_back(path);
+    }
+    stack.push_back(path);
+
+    std::string line, name;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (!includeName(line, name)) {
+            source += line;
+            source += '\n';
+        } else if (name.empty()) {
+            error = path + ":" + std::to_string(lineNumber) + ": expected #include \"file\"";
+            return false;
+        } else if (!expand(directoryOf(path) + name, stack, source, error, files)) {
+            return false;
+        }
+    }
+    stack.pop_back();
+    return true;
+}
+
+} // namespace
+
+bool readShaderIncludes(const std::string& path, std::string& source, std::string& error,
+                        std::vector<std::string>* files) {
+    std::vector<std::string> stack;
+    source.clear();
+    return expand(path, stack, source, error, files);
+}
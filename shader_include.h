@@ -0,0 +1,24 @@
+/*******************************************************************
+    Birthday Shader 2025 - #include for shader files
+
+    GLSL has no #include, so the shader's pieces (noise.glsl,
+    background.glsl, letters.glsl) are stitched together before the
+    driver sees them: a line `#include "file"` is replaced by that file,
+    found relative to the file that includes it. The same code runs at
+    build time, when embed_files bakes the flattened shader into the
+    binary, and at runtime when --shader loads it from disk instead.
+*******************************************************************/
+#ifndef SHADER_INCLUDE_H
+#define SHADER_INCLUDE_H
+
+#include <string>
+#include <vector>
+
+constexpr int SHADER_INCLUDE_MAX_DEPTH = 16;
+
+// Source of path with every #include expanded. files, when given, receives every file read,
+// path first, so a watcher can follow all of them
+bool readShaderIncludes(const std::string& path, std::string& source, std::string& error,
+                        std::vector<std::string>* files = nullptr);
+
+#endif // SHADER_INCLUDE_H
@@ -0,0 +1,83 @@
+/*******************************************************************
+    Birthday Shader 2025 - shader program
+*******************************************************************/
+#include "shader_program.h"
+
+#include <algorithm>
+#include <vector>
+
+ShaderProgram::~ShaderProgram() {
+    destroy();
+}
+
+void ShaderProgram::reset(GLuint newProgram) {
+    destroy();
+    program = newProgram;
+    if (program) {
+        reflect();
+    }
+}
+
+void ShaderProgram::destroy() {
+    if (program) {
+        glDeleteProgram(program);
+        program = 0;
+    }
+    uniforms.clear();
+    blocks.clear();
+}
+
+void ShaderProgram::use() const {
+    glUseProgram(program);
+}
+
+void ShaderProgram::reflect() {
+    GLint count = 0;
+    GLint longest = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &longest);
+    std::vector<GLchar> name(std::max(longest, 1));
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program, i, static_cast<GLsizei>(name.size()), &length, &size, &type, name.data());
+        std::string uniform(name.data(), length);
+        GLint location = glGetUniformLocation(program, uniform.c_str());
+        if (location < 0) {
+            continue;                       // In a uniform block
+        }
+        if ((uniform.size() > 3) && (uniform.compare(uniform.size() - 3, 3, "[0]") == 0)) {
+            uniform.resize(uniform.size() - 3);
+        }
+        uniforms[uniform] = location;
+    }
+
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &longest);
+    name.resize(std::max(longest, 1));
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        glGetActiveUniformBlockName(program, i, static_cast<GLsizei>(name.size()), &length, name.data());
+        blocks[std::string(name.data(), length)] = static_cast<GLuint>(i);
+    }
+}
+
+GLint ShaderProgram::location(const std::string& name) const {
+    auto found = uniforms.find(name);
+    return (found != uniforms.end()) ? found->second : -1;
+}
+
+void ShaderProgram::setSampler(const std::string& name, GLint unit) const {
+    GLint samplerLocation = location(name);
+    if (samplerLocation >= 0) {
+        glUniform1i(samplerLocation, unit);
+    }
+}
+
+void ShaderProgram::bindBlock(const std::string& name, GLuint binding) const {
+    auto found = blocks.find(name);
+    if (found != blocks.end()) {
+        glUniformBlockBinding(program, found->second, binding);
+    }
+}
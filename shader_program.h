@@ -0,0 +1,54 @@
+/*******************************************************************
+    Birthday Shader 2025 - shader program
+
+    Owns a linked program and knows what it declares. When a program
+    is handed over, straight from linking or from the program cache,
+    its active uniforms and uniform blocks are read once, so setting
+    it up asks the driver for nothing more. Once it is running, nothing
+    per frame or per window event asks the driver anything either: the
+    values that change live in the Animation block
+    (animation_block.h), and the program only has to be put in use.
+    The main program, the background pass and --bench's programs
+    are all held this way, so a hot-reloaded program is set up in
+    the same place as the one it replaces.
+*******************************************************************/
+#ifndef SHADER_PROGRAM_H
+#define SHADER_PROGRAM_H
+
+#include <GL/glew.h>
+
+#include <map>
+#include <string>
+
+class ShaderProgram {
+public:
+    ShaderProgram() = default;
+    ~ShaderProgram();
+
+    ShaderProgram(const ShaderProgram&) = delete;
+    ShaderProgram& operator=(const ShaderProgram&) = delete;
+
+    // Take over a linked program, deleting the one held before; 0 leaves it empty
+    void reset(GLuint program);
+    void destroy();
+
+    GLuint id() const { return program; }
+    void use() const;
+
+    // -1 for a uniform the program doesn't have, or that the compiler dropped as unused. Arrays go by
+    // their name without [0]
+    GLint location(const std::string& name) const;
+
+    // Both on the program in use, and skipped for what the program doesn't have
+    void setSampler(const std::string& name, GLint unit) const;
+    void bindBlock(const std::string& name, GLuint binding) const;
+
+private:
+    void reflect();
+
+    GLuint program = 0;
+    std::map<std::string, GLint> uniforms;  // Default-block uniforms; block members have no location
+    std::map<std::string, GLuint> blocks;   // Uniform block indices
+};
+
+#endif // SHADER_PROGRAM_H
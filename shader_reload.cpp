@@ -0,0 +1,363 @@
+/*******************************************************************
+    Birthday Shader 2025 - shader hot reload
+*******************************************************************/
+#include "shader_reload.h"
+#include "gl_common.h"
+#include "shader_include.h"
+
+#include <chrono>
+
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace {
+
+double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+long long modificationTime(const std::string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return 0;
+    }
+    return static_cast<long long>(info.st_mtime);
+}
+
+} // namespace
+
+/***************************** FileWatcher *****************************/
+
+FileWatcher::~FileWatcher() {
+#if defined(__linux__)
+    if (notifyFd >= 0) {
+        close(notifyFd);
+    }
+#endif
+}
+
+bool FileWatcher::watch(const std::string& filePath) {
+    path = filePath;
+    lastModified = modificationTime(path);
+    lastPoll = now();
+
+#if defined(__linux__)
+    // Watch the directory rather than the file: editors that save through a temporary
+    // file and a rename would otherwise leave the watch on the deleted original
+    size_t slash = path.find_last_of('/');
+    std::string directory = (slash == std::string::npos) ? "." : path.substr(0, slash + 1);
+    name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+
+    notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notifyFd < 0) {
+        return true;                        // Fall back to polling the modification time
+    }
+    watchDescriptor = inotify_add_watch(notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MODIFY);
+    if (watchDescriptor < 0) {
+        close(notifyFd);
+        notifyFd = -1;
+    }
+#endif
+    return true;
+}
+
+bool FileWatcher::pollEvents(double time) {
+#if defined(__linux__)
+    if (notifyFd >= 0) {
+        bool touched = false;
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(notifyFd, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + length; ) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                if ((event->len > 0) && (name == event->name)) {
+                    touched = true;
+                }
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+        return touched;
+    }
+#endif
+
+    if (time - lastPoll < RELOAD_POLL_SECONDS) {
+        return false;
+    }
+    lastPoll = time;
+    long long modified = modificationTime(path);
+    if (modified == lastModified) {
+        return false;
+    }
+    lastModified = modified;
+    return true;
+}
+
+bool FileWatcher::changed() {
+    double time = now();
+    if (pollEvents(time)) {
+        lastEvent = time;
+    }
+    if ((lastEvent >= 0.0) && (time - lastEvent >= RELOAD_SETTLE_SECONDS)) {
+        lastEvent = -1.0;
+        return true;
+    }
+    return false;
+}
+
+/***************************** ShaderReloader *****************************/
+
+bool parallelShaderCompileSupported() {
+    return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+}
+
+ShaderReloader::~ShaderReloader() {
+    stop();
+}
+
+bool ShaderReloader::start(const std::string& shaderPath, GLuint vs, const WorkerContext& workerContext,
+                           std::ostream& logStream) {
+    path = shaderPath;
+    vertexShader = vs;
+    log = &logStream;
+    std::string source, error;
+    std::vector<std::string> files;
+    readShaderIncludes(path, source, error, &files);
+    watchFiles(files.empty() ? std::vector<std::string>(1, path) : files);
+
+    useParallelCompile = parallelShaderCompileSupported();
+    if (useParallelCompile) {
+        // Let the driver pick how many compiler threads to use
+        if (GLEW_KHR_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        } else {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        }
+    } else if (workerContext.bind) {
+        stopping = false;
+        worker = std::thread(&ShaderReloader::workerLoop, this, workerContext);
+    }
+    return true;
+}
+
+void ShaderReloader::stop() {
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            stopping = true;
+        }
+        jobCondition.notify_all();
+        worker.join();
+    }
+    if (jobProgram) {
+        glDeleteProgram(jobProgram);
+        jobProgram = 0;
+    }
+    if (pendingProgram) {
+        glDeleteProgram(pendingProgram);
+        glDeleteShader(pendingShader);
+        pendingProgram = 0;
+        pendingShader = 0;
+    }
+    jobState = JOB_IDLE;
+}
+
+void ShaderReloader::watchFiles(const std::vector<std::string>& files) {
+    watchedFiles = files;
+    watchers.clear();
+    for (const std::string& file : files) {
+        watchers.emplace_back(new FileWatcher());
+        watchers.back()->watch(file);
+    }
+}
+
+bool ShaderReloader::readSource(std::string& source) {
+    std::string error;
+    std::vector<std::string> files;
+    if (!readShaderIncludes(path, source, error, &files)) {
+        reportFailure(error, "");
+        return false;
+    }
+    if (files != watchedFiles) {
+        watchFiles(files);
+    }
+    if (!defines.empty()) {
+        source = insertDefines(source, defines);
+    }
+    return true;
+}
+
+void ShaderReloader::reportFailure(const std::string& what, const std::string& details) const {
+    *log << what << ", keeping the previous shader" << std::endl;
+    if (!details.empty()) {
+        *log << details << std::endl;
+    }
+}
+
+void ShaderReloader::beginBuild(const std::string& source) {
+    const char* text = source.c_str();
+    if (useParallelCompile) {
+        // Both calls return immediately; completion is polled in finishParallelBuild
+        pendingShader = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(pendingShader, 1, &text, nullptr);
+        glCompileShader(pendingShader);
+        pendingProgram = glCreateProgram();
+        glAttachShader(pendingProgram, vertexShader);
+        glAttachShader(pendingProgram, pendingShader);
+        glLinkProgram(pendingProgram);
+    } else if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            jobSource = source;
+            jobState = JOB_QUEUED;
+        }
+        jobCondition.notify_all();
+    } else {
+        // No way to build in the background: compile right here and accept the hitch
+        GLuint shader = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(shader, 1, &text, nullptr);
+        glCompileShader(shader);
+        GLuint program = glCreateProgram();
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, shader);
+        glLinkProgram(program);
+
+        std::string error;
+        if (!shaderCompiled(shader, error) || !programLinked(program, error)) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+        glDeleteShader(shader);
+        jobProgram = program;
+        jobError = error;
+        jobState = JOB_DONE;
+    }
+}
+
+bool ShaderReloader::finishParallelBuild(GLuint& program) {
+    int complete = GL_FALSE;
+    glGetProgramiv(pendingProgram, GL_COMPLETION_STATUS_KHR, &complete);
+    if (!complete) {
+        return false;
+    }
+
+    std::string error;
+    bool built = shaderCompiled(pendingShader, error) && programLinked(pendingProgram, error);
+    glDetachShader(pendingProgram, pendingShader);
+    glDeleteShader(pendingShader);
+    if (built) {
+        program = pendingProgram;
+    } else {
+        glDeleteProgram(pendingProgram);
+        reportFailure("Shader reload failed", error);
+    }
+    pendingShader = 0;
+    pendingProgram = 0;
+    return true;
+}
+
+bool ShaderReloader::poll(GLuint& program) {
+    bool changed = false;
+    for (auto& watcher : watchers) {
+        changed = watcher->changed() || changed;    // Every watcher has to see its events through
+    }
+    if (changed) {
+        bool building = (pendingProgram != 0);
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            building = building || (jobState != JOB_IDLE);
+        }
+        std::string source;
+        if (building) {
+            rebuildPending = true;
+        } else if (readSource(source)) {
+            beginBuild(source);
+        }
+    }
+
+    bool finished = false;
+    bool swapped = false;
+    if (pendingProgram) {
+        GLuint built = 0;
+        finished = finishParallelBuild(built);
+        if (built) {
+            program = built;
+            swapped = true;
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        if (jobState == JOB_DONE) {
+            finished = true;
+            jobState = JOB_IDLE;
+            if (jobProgram) {
+                program = jobProgram;
+                jobProgram = 0;
+                swapped = true;
+            } else {
+                reportFailure("Shader reload failed", jobError);
+            }
+        }
+    }
+
+    // Saved again while the previous build was running: build the newest source too
+    std::string source;
+    if (finished && rebuildPending && readSource(source)) {
+        rebuildPending = false;
+        beginBuild(source);
+    }
+    return swapped;
+} // poll
+
+void ShaderReloader::workerLoop(WorkerContext context) {
+    if (!context.bind()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(jobMutex);
+    while (true) {
+        jobCondition.wait(lock, [this] { return stopping || (jobState == JOB_QUEUED); });
+        if (stopping) {
+            break;
+        }
+        std::string source;
+        source.swap(jobSource);
+        jobState = JOB_RUNNING;
+        lock.unlock();
+
+        const char* text = source.c_str();
+        GLuint shader = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(shader, 1, &text, nullptr);
+        glCompileShader(shader);
+        GLuint program = glCreateProgram();
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, shader);
+        glLinkProgram(program);
+
+        std::string error;
+        if (!shaderCompiled(shader, error) || !programLinked(program, error)) {
+            glDeleteProgram(program);
+            program = 0;
+        } else {
+            glDetachShader(program, shader);
+        }
+        glDeleteShader(shader);
+        // The render context only sees a complete program once this context has finished with it
+        glFinish();
+
+        lock.lock();
+        jobProgram = program;
+        jobError = error;
+        jobState = JOB_DONE;
+    }
+    lock.unlock();
+
+    if (context.release) {
+        context.release();
+    }
+} // workerLoop
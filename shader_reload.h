@@ -0,0 +1,124 @@
+/*******************************************************************
+    Birthday Shader 2025 - shader hot reload
+
+    Watches the shader loaded with --shader, and every file it includes,
+    and rebuilds the program in the background whenever one is saved. With GL_KHR_parallel_shader_compile the driver
+    compiles on its own threads and the render loop just polls for
+    completion; otherwise a worker thread with a context that shares
+    objects with the render context does the compile and link. The new
+    program is only handed over once it has linked, so a typo leaves
+    the old program (and the running animation) untouched.
+*******************************************************************/
+#ifndef SHADER_RELOAD_H
+#define SHADER_RELOAD_H
+
+#include <GL/glew.h>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr double RELOAD_SETTLE_SECONDS = 0.1;   // Editors often save in several writes
+constexpr double RELOAD_POLL_SECONDS = 0.25;    // stat() interval where inotify isn't available
+
+// Reports when a file has been rewritten; inotify on Linux, modification time elsewhere
+class FileWatcher {
+public:
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool watch(const std::string& path);
+
+    // Never blocks; true once per burst of writes, after RELOAD_SETTLE_SECONDS of quiet
+    bool changed();
+
+private:
+    bool pollEvents(double now);
+
+    std::string path;
+    std::string name;                       // File name inside the watched directory
+    int notifyFd = -1;
+    int watchDescriptor = -1;
+    long long lastModified = 0;
+    double lastPoll = 0.0;
+    double lastEvent = -1.0;                // < 0: nothing pending
+};
+
+// GL_KHR/ARB_parallel_shader_compile: no worker context is needed when this is true
+bool parallelShaderCompileSupported();
+
+// Shader context for the worker thread: bind makes it current on the calling thread
+struct WorkerContext {
+    std::function<bool()> bind;
+    std::function<void()> release;
+};
+
+class ShaderReloader {
+public:
+    ShaderReloader() = default;
+    ~ShaderReloader();
+
+    ShaderReloader(const ShaderReloader&) = delete;
+    ShaderReloader& operator=(const ShaderReloader&) = delete;
+
+    // Needs the render context current. worker is only used without parallel shader compile
+    bool start(const std::string& shaderPath, GLuint vertexShader, const WorkerContext& worker, std::ostream& log);
+    void stop();
+
+    // Call once per frame on the render thread. Returns true with the new program when one has
+    // linked; the caller switches to it and deletes its old program. Never waits on the compiler
+    bool poll(GLuint& program);
+
+    bool parallelCompile() const { return useParallelCompile; }
+
+    // Lines put after #version in every rebuilt source, so reloads keep the startup #defines
+    void setDefines(const std::string& lines) { defines = lines; }
+
+private:
+    enum JobState {
+        JOB_IDLE,
+        JOB_QUEUED,                         // Worker: source handed over, not picked up yet
+        JOB_RUNNING,
+        JOB_DONE                            // Worker: result ready for poll()
+    };
+
+    void beginBuild(const std::string& source);
+    bool finishParallelBuild(GLuint& program);
+    void workerLoop(WorkerContext worker);
+    bool readSource(std::string& source);     // Also follows any change in what the shader includes
+    void watchFiles(const std::vector<std::string>& files);
+    void reportFailure(const std::string& what, const std::string& details) const;
+
+    std::string path;
+    std::string defines;
+    GLuint vertexShader = 0;
+    std::ostream* log = nullptr;
+    std::vector<std::string> watchedFiles;
+    std::vector<std::unique_ptr<FileWatcher>> watchers;
+    bool useParallelCompile = false;
+    bool rebuildPending = false;            // Saved again while a build was running
+
+    // Parallel compile: objects being built by the driver
+    GLuint pendingShader = 0;
+    GLuint pendingProgram = 0;
+
+    // Worker thread
+    std::thread worker;
+    std::mutex jobMutex;
+    std::condition_variable jobCondition;
+    JobState jobState = JOB_IDLE;
+    bool stopping = false;
+    std::string jobSource;
+    GLuint jobProgram = 0;                  // 0 when the build failed
+    std::string jobError;
+};
+
+#endif // SHADER_RELOAD_H
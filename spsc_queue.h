@@ -0,0 +1,53 @@
+/*******************************************************************
+    Birthday Shader 2025 - lock-free single producer, single consumer queue
+
+    A fixed ring of Capacity slots between exactly two threads: one
+    only ever pushes, the other only ever pops. Neither side takes a
+    lock or waits, so a callback can hand work to the render thread
+    (or back) without stalling behind a frame in progress.
+*******************************************************************/
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    SpscQueue() = default;
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer thread only; false when the queue is full
+    bool push(const T& item) {
+        size_t tail = writeIndex.load(std::memory_order_relaxed);
+        if (tail - readIndex.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots[tail & (Capacity - 1)] = item;
+        writeIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only; false when the queue is empty
+    bool pop(T& item) {
+        size_t head = readIndex.load(std::memory_order_relaxed);
+        if (head == writeIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = slots[head & (Capacity - 1)];
+        readIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T slots[Capacity];
+    alignas(64) std::atomic<size_t> writeIndex{0};  // Own cache lines, so the two threads don't fight over one
+    alignas(64) std::atomic<size_t> readIndex{0};
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,236 @@
+/*******************************************************************
+    Birthday Shader 2025 - live frame telemetry
+*******************************************************************/
+#include "telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// The slots start on a cache line of their own
+constexpr size_t HEADER_SIZE = (sizeof(TelemetryHeader) + 63) / 64 * 64;
+constexpr size_t SEGMENT_SIZE = HEADER_SIZE + sizeof(TelemetrySlot) * TELEMETRY_CAPACITY;
+
+} // namespace
+
+int64_t telemetryNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/***************************** TelemetrySegment *****************************/
+
+TelemetrySegment::~TelemetrySegment() {
+    close();
+}
+
+TelemetrySlot* TelemetrySegment::slots() const {
+    return reinterpret_cast<TelemetrySlot*>(static_cast<char*>(memory) + HEADER_SIZE);
+}
+
+bool TelemetrySegment::map(const std::string& name, bool create, std::string& error) {
+    close();
+    if (name.empty() || (name.find_first_of("/\\") != std::string::npos)) {
+        error = "telemetry name must be non-empty and without slashes: " + name;
+        return false;
+    }
+#if defined(_WIN32)
+    std::string path = "Local\\" + name;
+    HANDLE mapping = create ?
+        CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(SEGMENT_SIZE), path.c_str()) :
+        OpenFileMappingA(FILE_MAP_READ, FALSE, path.c_str());
+    if (!mapping) {
+        error = "can't " + std::string(create ? "create" : "open") + " shared memory " + path + " (error " +
+            std::to_string(GetLastError()) + ")";
+        return false;
+    }
+    memory = MapViewOfFile(mapping, create ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, SEGMENT_SIZE);
+    if (!memory) {
+        error = "can't map shared memory " + path + " (error " + std::to_string(GetLastError()) + ")";
+        CloseHandle(mapping);
+        return false;
+    }
+    handle = mapping;
+#else
+    std::string path = "/" + name;
+    int fd = shm_open(path.c_str(), create ? (O_CREAT | O_RDWR) : O_RDONLY, 0644);
+    if (fd < 0) {
+        error = "can't " + std::string(create ? "create" : "open") + " shared memory " + path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat info;
+    bool sized = create ? (ftruncate(fd, SEGMENT_SIZE) == 0) :
+        ((fstat(fd, &info) == 0) && (static_cast<size_t>(info.st_size) >= SEGMENT_SIZE));
+    if (!sized) {
+        error = create ? "can't size shared memory " + path + ": " + strerror(errno) :
+            path + " is not a telemetry segment of this version";
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, SEGMENT_SIZE, create ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        error = "can't map shared memory " + path + ": " + strerror(errno);
+        if (create) {
+            shm_unlink(path.c_str());
+        }
+        return false;
+    }
+    memory = mapped;
+    if (create) {
+        unlinkName = path;
+    }
+#endif
+    size = SEGMENT_SIZE;
+    return true;
+} // map
+
+bool TelemetrySegment::create(const std::string& name, std::string& error) {
+    if (!map(name, true, error)) {
+        return false;
+    }
+    // A segment left behind by a run that crashed is taken over; readers see the new start time.
+    // The magic goes in last, so a reader never takes a half-made header for a real one
+    TelemetryHeader* head = header();
+    head->magic = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    memset(static_cast<char*>(memory) + sizeof(uint32_t), 0, SEGMENT_SIZE - sizeof(uint32_t));
+    head->version = TELEMETRY_VERSION;
+    head->capacity = TELEMETRY_CAPACITY;
+    head->slotSize = sizeof(TelemetrySlot);
+    head->startNanoseconds = telemetryNow();
+    std::atomic_thread_fence(std::memory_order_release);
+    head->magic = TELEMETRY_MAGIC;
+    return true;
+}
+
+bool TelemetrySegment::open(const std::string& name, std::string& error) {
+    if (!map(name, false, error)) {
+        return false;
+    }
+    const TelemetryHeader* head = header();
+    if ((head->magic != TELEMETRY_MAGIC) || (head->version != TELEMETRY_VERSION) ||
+        (head->capacity != TELEMETRY_CAPACITY) || (head->slotSize != sizeof(TelemetrySlot))) {
+        error = "shared memory " + name + " is not ready, or from another version";
+        close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+}
+
+void TelemetrySegment::close() {
+    if (!memory) {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(memory);
+    CloseHandle(static_cast<HANDLE>(handle));
+    handle = nullptr;
+#else
+    munmap(memory, size);
+    if (!unlinkName.empty()) {
+        shm_unlink(unlinkName.c_str());     // Readers still mapping it keep their copy until they let go
+        unlinkName.clear();
+    }
+#endif
+    memory = nullptr;
+    size = 0;
+}
+
+/***************************** TelemetryWriter *****************************/
+
+bool TelemetryWriter::create(const std::string& name, std::string& error) {
+    frames = 0;
+    lastPresent = 0;
+    return segment.create(name, error);
+}
+
+void TelemetryWriter::publish(TelemetryFrame& frame) {
+    TelemetryHeader* head = segment.header();
+    if (!head) {
+        return;
+    }
+    int64_t now = telemetryNow();
+    frame.frame = ++frames;
+    frame.presentNanoseconds = now;
+    frame.intervalMilliseconds = lastPresent ? static_cast<float>((now - lastPresent) / 1.0e6) : 0.0f;
+    lastPresent = now;
+
+    // Cleared while the data is half written; the number of the frame once it is whole
+    TelemetrySlot& slot = segment.slots()[(frames - 1) % TELEMETRY_CAPACITY];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.data = frame;
+    slot.sequence.store(frames, std::memory_order_release);
+    head->published.store(frames, std::memory_order_release);
+}
+
+/***************************** TelemetryReader *****************************/
+
+bool TelemetryReader::open(const std::string& name, std::string& error) {
+    return segment.open(name, error);       // Reopening the same run carries on after the last frame read
+}
+
+bool TelemetryReader::readSlot(uint64_t frame, TelemetryFrame& out) const {
+    const TelemetrySlot& slot = segment.slots()[(frame - 1) % TELEMETRY_CAPACITY];
+    if (slot.sequence.load(std::memory_order_acquire) != frame) {
+        return false;                       // Being rewritten, or already holds a later frame
+    }
+    // Another process may be writing it right now; the copy only counts if the number didn't move
+    memcpy(&out, &slot.data, sizeof(out));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == frame;
+}
+
+void TelemetryReader::readNew(std::vector<TelemetryFrame>& frames) {
+    frames.clear();
+    const TelemetryHeader* head = segment.header();
+    if (!head) {
+        return;
+    }
+    if (head->startNanoseconds != runStart) {
+        runStart = head->startNanoseconds;
+        lastRead = 0;
+    }
+    uint64_t published = head->published.load(std::memory_order_acquire);
+    uint64_t first = std::max(lastRead + 1, (published > TELEMETRY_CAPACITY) ? published - TELEMETRY_CAPACITY + 1 : 1);
+    TelemetryFrame frame;
+    for (uint64_t n = first; n <= published; n++) {
+        if (readSlot(n, frame)) {
+            frames.push_back(frame);
+        }
+    }
+    lastRead = std::max(lastRead, published);
+}
+
+bool TelemetryReader::latest(TelemetryFrame& frame) const {
+    const TelemetryHeader* head = segment.header();
+    if (!head) {
+        return false;
+    }
+    // The writer may lap the slot between the two loads; try the next newest a few times
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint64_t published = head->published.load(std::memory_order_acquire);
+        if (published == 0) {
+            return false;
+        }
+        if (readSlot(published, frame)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,131 @@
+/*******************************************************************
+    Birthday Shader 2025 - live frame telemetry
+
+    With --telemetry NAME every presented frame (its interval, GPU
+    time, resolutions, vsync and idle state, dropped frames so far) is
+    published into a ring of TELEMETRY_CAPACITY frames in a named
+    shared memory segment, for monitoring to read while the display
+    runs unattended. The renderer only ever writes: each slot carries a
+    sequence number that is cleared while the slot is rewritten and set
+    to the frame number once it is complete, so a reader copies a slot
+    and keeps it only if the number was the same before and after. A
+    reader that falls behind loses frames, never the renderer time.
+    telemetry_reader turns the ring into Prometheus textfile-collector
+    metrics.
+*******************************************************************/
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+constexpr uint32_t TELEMETRY_MAGIC = 0x54545342;    // "BSTT"
+constexpr uint32_t TELEMETRY_VERSION = 1;
+constexpr uint32_t TELEMETRY_CAPACITY = 4096;       // Frames, about half a minute at 144 Hz
+constexpr const char* TELEMETRY_DEFAULT_NAME = "birthdayshader";  // telemetry_reader's --name
+
+enum TelemetryFlags : uint32_t {
+    TELEMETRY_VSYNC = 1,
+    TELEMETRY_IDLE = 2,                     // Unfocused or iconified, paced down to the idle rate
+    TELEMETRY_DYNAMIC_RESOLUTION = 4
+};
+
+// One presented frame. Plain data, so every process sees the same layout
+struct TelemetryFrame {
+    uint64_t frame;                         // Frames presented so far, this one included
+    int64_t presentNanoseconds;             // steady_clock at the swap, which is the same clock in every process
+    float intervalMilliseconds;             // Since the previous swap, 0 for the first frame
+    float gpuMilliseconds;                  // Smoothed GPU time of the scene; 0 until measured, or without dynamic resolution
+    uint32_t renderWidth;                   // The scene's size after dynamic resolution
+    uint32_t renderHeight;
+    uint32_t outputWidth;                   // The window's framebuffer
+    uint32_t outputHeight;
+    uint64_t droppedFrames;                 // So far; see FramePacer::droppedFrames()
+    uint32_t flags;                         // TelemetryFlags
+    uint32_t padding;
+};
+
+struct TelemetrySlot {
+    std::atomic<uint64_t> sequence;         // frame once complete, 0 while being written
+    TelemetryFrame data;
+};
+
+// The start of the segment; the slots follow
+struct TelemetryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t slotSize;
+    int64_t startNanoseconds;               // When the writer started; a new value means a new run
+    std::atomic<uint64_t> published;        // Frames written; frame N is in slot (N - 1) % capacity
+};
+
+// The shared memory itself, created by the renderer and opened by readers
+class TelemetrySegment {
+public:
+    TelemetrySegment() = default;
+    ~TelemetrySegment();
+
+    TelemetrySegment(const TelemetrySegment&) = delete;
+    TelemetrySegment& operator=(const TelemetrySegment&) = delete;
+
+    bool create(const std::string& name, std::string& error);
+    bool open(const std::string& name, std::string& error);
+    void close();
+
+    TelemetryHeader* header() const { return static_cast<TelemetryHeader*>(memory); }
+    TelemetrySlot* slots() const;
+
+private:
+    bool map(const std::string& name, bool create, std::string& error);
+
+    void* memory = nullptr;
+    size_t size = 0;
+    void* handle = nullptr;                 // The file mapping on Windows
+    std::string unlinkName;                 // Set for the creator, removed on close
+};
+
+// Renderer side: one thread publishes, without ever waiting
+class TelemetryWriter {
+public:
+    bool create(const std::string& name, std::string& error);
+    void destroy() { segment.close(); }
+    bool active() const { return segment.header() != nullptr; }
+
+    // Fills in frame, presentNanoseconds and intervalMilliseconds
+    void publish(TelemetryFrame& frame);
+
+private:
+    TelemetrySegment segment;
+    uint64_t frames = 0;
+    int64_t lastPresent = 0;
+};
+
+// Monitoring side
+class TelemetryReader {
+public:
+    bool open(const std::string& name, std::string& error);
+    void close() { segment.close(); }
+    bool isOpen() const { return segment.header() != nullptr; }
+
+    // Frames published since the last call that are still in the ring, oldest first. A new run of the
+    // renderer starts over from its first frame still in the ring
+    void readNew(std::vector<TelemetryFrame>& frames);
+
+    // The newest frame; false if none has been published yet
+    bool latest(TelemetryFrame& frame) const;
+
+private:
+    bool readSlot(uint64_t frame, TelemetryFrame& out) const;
+
+    TelemetrySegment segment;
+    int64_t runStart = 0;
+    uint64_t lastRead = 0;
+};
+
+// steady_clock in nanoseconds, as presentNanoseconds holds it
+int64_t telemetryNow();
+
+#endif // TELEMETRY_H
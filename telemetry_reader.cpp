@@ -0,0 +1,229 @@
+/*******************************************************************
+    Birthday Shader 2025 - frame telemetry for Prometheus
+
+        telemetry_reader [--name NAME] [--interval SECONDS] [--once] FILE
+
+    Reads what birthdayshader --telemetry NAME publishes (telemetry.h)
+    and every interval rewrites FILE in the Prometheus text format, for
+    node_exporter's textfile collector: frame rate, frame interval
+    mean/p99/max over the interval, dropped frames, GPU time, render and
+    window resolution, vsync and idle state, and how long ago the last
+    frame was presented. FILE is written next to itself and renamed
+    into place, so the collector never sees half of it; "-" prints to
+    stdout. Only ever reads the shared memory, so the renderer doesn't
+    notice how often or how slowly it runs.
+*******************************************************************/
+#include "telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr double DEFAULT_INTERVAL_SECONDS = 15.0;   // node_exporter's default scrape interval
+constexpr double STALE_SECONDS = 5.0;               // No frame for this long and the display counts as down
+
+namespace {
+
+struct ReaderOptions {
+    std::string name = TELEMETRY_DEFAULT_NAME;
+    double interval = DEFAULT_INTERVAL_SECONDS;
+    bool once = false;
+    std::string outputPath;
+};
+
+bool parseArgs(int argc, char* argv[], ReaderOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool needsValue = (strcmp(arg, "--name") == 0) || (strcmp(arg, "--interval") == 0);
+        if (needsValue && !value) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        if (strcmp(arg, "--name") == 0) {
+            options.name = value;
+            i++;
+        } else if (strcmp(arg, "--interval") == 0) {
+            options.interval = atof(value);
+            if (options.interval <= 0.0) {
+                std::cerr << "Invalid interval: " << value << std::endl;
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--once") == 0) {
+            options.once = true;
+        } else if ((arg[0] != '-') || (strcmp(arg, "-") == 0)) {
+            options.outputPath = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options.outputPath.empty();
+}
+
+// Nearest-rank percentile of sorted values
+double percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.999999);
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+class MetricWriter {
+public:
+    MetricWriter(std::ostream& out, const std::string& display) : out(out), label("display=\"" + display + "\"") {}
+
+    void describe(const char* name, const char* type, const char* help) {
+        out << "# HELP birthdayshader_" << name << " " << help << "\n";
+        out << "# TYPE birthdayshader_" << name << " " << type << "\n";
+    }
+
+    void value(const char* name, double value, const char* extraLabel = nullptr) {
+        char number[64];
+        snprintf(number, sizeof(number), "%.9g", value);
+        out << "birthdayshader_" << name << "{" << label << (extraLabel ? "," : "") << (extraLabel ? extraLabel : "")
+            << "} " << number << "\n";
+    }
+
+    void gauge(const char* name, const char* help, double v) {
+        describe(name, "gauge", help);
+        value(name, v);
+    }
+
+private:
+    std::ostream& out;
+    std::string label;
+};
+
+// What the frames of one interval add up to, in the text format
+std::string formatMetrics(const ReaderOptions& options, bool haveLatest, const TelemetryFrame& latest,
+                          const std::vector<TelemetryFrame>& frames) {
+    std::ostringstream text;
+    MetricWriter metrics(text, options.name);
+    double age = haveLatest ? (telemetryNow() - latest.presentNanoseconds) / 1.0e9 : -1.0;
+    bool up = haveLatest && (age < STALE_SECONDS);
+    metrics.gauge("up", "1 while the display is presenting frames", up ? 1.0 : 0.0);
+    if (!haveLatest) {
+        return text.str();
+    }
+    metrics.gauge("last_frame_age_seconds", "Time since the newest frame was presented", age);
+
+    metrics.describe("frames_total", "counter", "Frames presented since the renderer started");
+    metrics.value("frames_total", static_cast<double>(latest.frame));
+    metrics.describe("dropped_frames_total", "counter",
+                     "Frame intervals more than 1.5 target periods long since the renderer started");
+    metrics.value("dropped_frames_total", static_cast<double>(latest.droppedFrames));
+
+    // Rates and spreads over this interval's frames only; an idle interval has none
+    std::vector<double> intervals;
+    double gpu = 0.0;
+    for (const TelemetryFrame& frame : frames) {
+        if (frame.intervalMilliseconds > 0.0f) {
+            intervals.push_back(frame.intervalMilliseconds);
+        }
+        gpu += frame.gpuMilliseconds;
+    }
+    if (frames.size() >= 2) {
+        const TelemetryFrame& first = frames.front();
+        const TelemetryFrame& last = frames.back();
+        double seconds = (last.presentNanoseconds - first.presentNanoseconds) / 1.0e9;
+        if (seconds > 0.0) {
+            metrics.gauge("fps", "Frames presented per second over the last interval", (last.frame - first.frame) / seconds);
+        }
+    }
+    if (!intervals.empty()) {
+        std::sort(intervals.begin(), intervals.end());
+        double sum = 0.0;
+        for (double interval : intervals) {
+            sum += interval;
+        }
+        metrics.describe("frame_interval_milliseconds", "gauge", "Time between presents over the last interval");
+        metrics.value("frame_interval_milliseconds", sum / intervals.size(), "stat=\"mean\"");
+        metrics.value("frame_interval_milliseconds", percentile(intervals, 99.0), "stat=\"p99\"");
+        metrics.value("frame_interval_milliseconds", intervals.back(), "stat=\"max\"");
+    }
+    if (!frames.empty()) {
+        metrics.gauge("gpu_milliseconds", "Smoothed GPU time of the scene over the last interval", gpu / frames.size());
+    }
+
+    metrics.gauge("render_width", "Width the scene is rendered at, after dynamic resolution", latest.renderWidth);
+    metrics.gauge("render_height", "Height the scene is rendered at, after dynamic resolution", latest.renderHeight);
+    metrics.gauge("output_width", "Width of the window's framebuffer", latest.outputWidth);
+    metrics.gauge("output_height", "Height of the window's framebuffer", latest.outputHeight);
+    metrics.gauge("vsync", "1 with vsync on", (latest.flags & TELEMETRY_VSYNC) ? 1.0 : 0.0);
+    metrics.gauge("idle", "1 while unfocused or iconified and paced down to the idle rate",
+                  (latest.flags & TELEMETRY_IDLE) ? 1.0 : 0.0);
+    metrics.gauge("dynamic_resolution", "1 with dynamic resolution on",
+                  (latest.flags & TELEMETRY_DYNAMIC_RESOLUTION) ? 1.0 : 0.0);
+    return text.str();
+} // formatMetrics
+
+bool writeMetrics(const std::string& path, const std::string& text) {
+    if (path == "-") {
+        std::cout << text << std::flush;
+        return true;
+    }
+    std::string temporary = path + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    bool written = (fwrite(text.data(), 1, text.size(), file) == text.size());
+    written = (fclose(file) == 0) && written;
+#if defined(_WIN32)
+    remove(path.c_str());                   // rename() won't replace a file on Windows
+#endif
+    return written && (rename(temporary.c_str(), path.c_str()) == 0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ReaderOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--name NAME] [--interval SECONDS] [--once] FILE" << std::endl <<
+            "  --name NAME        what birthdayshader was given with --telemetry (default " << TELEMETRY_DEFAULT_NAME << ")" <<
+            std::endl <<
+            "  --interval SECONDS how often FILE is rewritten (default " << DEFAULT_INTERVAL_SECONDS << ")" << std::endl <<
+            "  --once             write FILE once and exit" << std::endl <<
+            "  FILE               Prometheus text file, e.g. in node_exporter's textfile directory; - for stdout" << std::endl;
+        return 1;
+    }
+
+    TelemetryReader reader;
+    std::string lastError;
+    std::vector<TelemetryFrame> frames;
+    for (;;) {
+        // (Re)open until the renderer is there; a renderer that restarts makes a new segment
+        if (!reader.isOpen()) {
+            std::string error;
+            if (!reader.open(options.name, error) && (error != lastError)) {
+                std::cerr << error << std::endl;
+            }
+            lastError = error;
+        }
+        reader.readNew(frames);
+        int64_t since = telemetryNow() - static_cast<int64_t>(options.interval * 1.0e9);
+        frames.erase(frames.begin(), std::find_if(frames.begin(), frames.end(), [since](const TelemetryFrame& frame) {
+            return frame.presentNanoseconds >= since;
+        }));
+        TelemetryFrame latest;
+        bool haveLatest = reader.latest(latest);
+        if (!writeMetrics(options.outputPath, formatMetrics(options, haveLatest, latest, frames))) {
+            std::cerr << "Failed to write " << options.outputPath << std::endl;
+            return 1;
+        }
+        if (reader.isOpen() && frames.empty()) {
+            reader.close();                 // Nothing new: the renderer may have gone, look again next time
+        }
+        if (options.once) {
+            return 0;
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(options.interval));
+    }
+}
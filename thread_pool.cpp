@@ -0,0 +1,113 @@
+/*******************************************************************
+    Birthday Shader 2025 - work-stealing thread pool
+*******************************************************************/
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(uint32_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    for (uint32_t i = 0; i < threadCount; i++) {
+        queues.emplace_back(new WorkQueue());
+    }
+    // Worker 0 is whoever calls parallelFor(), so only spawn the others
+    for (uint32_t i = 1; i < threadCount; i++) {
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallelFor(uint32_t count, const std::function<void(uint32_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+
+    currentTask = &task;
+    remaining = count;
+    steals = 0;
+
+    // Hand out contiguous runs so neighbouring tiles start on the same worker
+    uint32_t workers = size();
+    for (uint32_t w = 0; w < workers; w++) {
+        uint32_t begin = static_cast<uint32_t>(uint64_t(count) * w / workers);
+        uint32_t end = static_cast<uint32_t>(uint64_t(count) * (w + 1) / workers);
+        std::lock_guard<std::mutex> lock(queues[w]->mutex);
+        for (uint32_t i = begin; i < end; i++) {
+            queues[w]->tasks.push_back(i);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        generation++;
+    }
+    wakeCondition.notify_all();
+
+    runTasks(0);
+
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    doneCondition.wait(lock, [this] { return remaining.load() == 0; });
+    currentTask = nullptr;
+}
+
+void ThreadPool::workerLoop(uint32_t worker) {
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait(lock, [&] { return stopping || (generation != seenGeneration); });
+            if (stopping) {
+                return;
+            }
+            seenGeneration = generation;
+        }
+        runTasks(worker);
+    }
+}
+
+bool ThreadPool::popOrSteal(uint32_t worker, uint32_t& task) {
+    {
+        WorkQueue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    // Own deque is empty: steal from the back of the others, starting with our neighbour
+    uint32_t workers = size();
+    for (uint32_t i = 1; i < workers; i++) {
+        WorkQueue& victim = *queues[(worker + i) % workers];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runTasks(uint32_t worker) {
+    uint32_t task = 0;
+    while (popOrSteal(worker, task)) {
+        (*currentTask)(task);
+        if (--remaining == 0) {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            doneCondition.notify_all();
+        }
+    }
+}
@@ -0,0 +1,63 @@
+/*******************************************************************
+    Birthday Shader 2025 - work-stealing thread pool
+
+    Each worker owns a deque of task indices. A worker pops from the
+    front of its own deque and, once that runs dry, steals from the
+    back of the other workers' deques, so uneven tiles (the letters
+    are far more expensive than the background) balance themselves.
+*******************************************************************/
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // threadCount includes the calling thread, which also does work in parallelFor()
+    explicit ThreadPool(uint32_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    uint32_t size() const { return static_cast<uint32_t>(queues.size()); }
+
+    // Run task(index) for every index in [0, count) and block until all are done
+    void parallelFor(uint32_t count, const std::function<void(uint32_t)>& task);
+
+    // Number of tasks that were taken from another worker's deque during the last parallelFor()
+    uint32_t lastStealCount() const { return steals.load(); }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<uint32_t> tasks;
+    };
+
+    void workerLoop(uint32_t worker);
+    bool popOrSteal(uint32_t worker, uint32_t& task);
+    void runTasks(uint32_t worker);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+    uint64_t generation = 0;
+    bool stopping = false;
+
+    const std::function<void(uint32_t)>* currentTask = nullptr;
+    std::atomic<uint32_t> remaining{0};
+    std::atomic<uint32_t> steals{0};
+};
+
+#endif // THREAD_POOL_H
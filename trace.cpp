@@ -0,0 +1,184 @@
+/*******************************************************************
+    Birthday Shader 2025 - startup and frame trace
+*******************************************************************/
+#include "trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+/***************************** Tracer *****************************/
+
+Tracer::Tracer() : origin(std::chrono::steady_clock::now()), events(new Event[TRACE_CAPACITY]) {
+}
+
+int64_t Tracer::now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+uint64_t Tracer::slot(uint64_t index) {
+    if (index < TRACE_KEEP_EVENTS) {
+        return index;
+    }
+    return TRACE_KEEP_EVENTS + (index - TRACE_KEEP_EVENTS) % (TRACE_CAPACITY - TRACE_KEEP_EVENTS);
+}
+
+uint32_t Tracer::currentThread() {
+    // Only one tracer ever records per run, so one id per thread is enough
+    thread_local uint32_t id = threadCount.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void Tracer::record(const char* name, int64_t start, int64_t end, uint32_t thread) {
+    uint64_t index = next.fetch_add(1, std::memory_order_relaxed);
+    Event& event = events[slot(index)];
+
+    // A writer marks the slot unfinished first, so write() can tell a slot being replaced from a complete one
+    event.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(start, std::memory_order_relaxed);
+    event.end.store(end, std::memory_order_relaxed);
+    event.thread.store(thread, std::memory_order_relaxed);
+    event.sequence.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::nameThread(const char* name) {
+    uint32_t thread = currentThread();
+    std::lock_guard<std::mutex> lock(nameMutex);
+    threadNames.push_back(std::make_pair(thread, std::string(name)));
+}
+
+bool Tracer::write(const std::string& path, std::ostream& log) const {
+    std::ofstream out(path);
+    if (!out) {
+        log << "Failed to write trace: " << path << std::endl;
+        return false;
+    }
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+    char line[256];
+    snprintf(line, sizeof(line), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"GPU\"}}",
+             TRACE_GPU_THREAD);
+    out << line;
+    {
+        std::lock_guard<std::mutex> lock(nameMutex);
+        for (const auto& thread : threadNames) {
+            snprintf(line, sizeof(line), ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                     thread.first, thread.second.c_str());
+            out << line;
+        }
+    }
+
+    // The kept startup events, then whatever the ring still holds
+    uint64_t end = next.load(std::memory_order_acquire);
+    uint64_t ringStart = std::max(TRACE_KEEP_EVENTS, (end > TRACE_CAPACITY - TRACE_KEEP_EVENTS) ?
+                                  end - (TRACE_CAPACITY - TRACE_KEEP_EVENTS) : 0);
+    uint64_t written = 0;
+    for (uint64_t index = 0; index < end; index++) {
+        if ((index >= TRACE_KEEP_EVENTS) && (index < ringStart)) {
+            index = ringStart;
+        }
+        const Event& event = events[slot(index)];
+        uint64_t before = event.sequence.load(std::memory_order_acquire);
+        const char* name = event.name.load(std::memory_order_relaxed);
+        int64_t start = event.start.load(std::memory_order_relaxed);
+        int64_t finish = event.end.load(std::memory_order_relaxed);
+        uint32_t thread = event.thread.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((before != index + 1) || (event.sequence.load(std::memory_order_relaxed) != before)) {
+            continue;                       // Not finished yet, or already being replaced
+        }
+        // Microseconds, as the format wants
+        snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                 name, thread, start / 1000.0, (finish - start) / 1000.0);
+        out << line;
+        written++;
+    }
+    out << "\n]}" << std::endl;
+    if (!out) {
+        log << "Failed to write trace: " << path << std::endl;
+        return false;
+    }
+    log << "Trace written to " << path << " (" << written << " spans)" << std::endl;
+    return true;
+} // write
+
+/***************************** GpuTrace *****************************/
+
+GpuTrace::~GpuTrace() {
+    destroy();
+}
+
+bool GpuTrace::create(Tracer* traceTo) {
+    tracer = traceTo;
+    if (!tracer) {
+        return false;
+    }
+    for (Span& span : spans) {
+        glGenQueries(2, span.queries);
+    }
+    calibrate();
+    return true;
+}
+
+void GpuTrace::destroy() {
+    if (tracer) {
+        for (Span& span : spans) {
+            glDeleteQueries(2, span.queries);
+        }
+        tracer = nullptr;
+    }
+}
+
+void GpuTrace::calibrate() {
+    // GL_TIMESTAMP read back directly is the GPU's time now, with no commands queued in front of it
+    int64_t before = tracer->now();
+    GLint64 gpuTime = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+    int64_t after = tracer->now();
+    gpuToTracer = (before + after) / 2 - static_cast<int64_t>(gpuTime);
+    lastCalibration = after;
+}
+
+void GpuTrace::begin(const char* name) {
+    if (!tracer || open || (issued - collected == TRACE_GPU_QUERY_PAIRS)) {
+        return;
+    }
+    Span& span = spans[issued % TRACE_GPU_QUERY_PAIRS];
+    span.name = name;
+    glQueryCounter(span.queries[0], GL_TIMESTAMP);
+    open = true;
+}
+
+void GpuTrace::end() {
+    if (!open) {
+        return;
+    }
+    glQueryCounter(spans[issued % TRACE_GPU_QUERY_PAIRS].queries[1], GL_TIMESTAMP);
+    issued++;
+    open = false;
+}
+
+void GpuTrace::collect() {
+    if (!tracer) {
+        return;
+    }
+    // Spans finish in order, so stop at the first one the GPU hasn't reached the end of
+    while (collected != issued) {
+        const Span& span = spans[collected % TRACE_GPU_QUERY_PAIRS];
+        GLint available = 0;
+        glGetQueryObjectiv(span.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        GLuint64 start = 0, end = 0;
+        glGetQueryObjectui64v(span.queries[0], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(span.queries[1], GL_QUERY_RESULT, &end);
+        tracer->record(span.name, static_cast<int64_t>(start) + gpuToTracer, static_cast<int64_t>(end) + gpuToTracer,
+                       TRACE_GPU_THREAD);
+        collected++;
+    }
+    if (tracer->now() - lastCalibration > static_cast<int64_t>(TRACE_GPU_CALIBRATE_SECONDS * 1e9)) {
+        calibrate();                        // The two clocks drift apart over a long run
+    }
+} // collect
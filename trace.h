@@ -0,0 +1,135 @@
+/*******************************************************************
+    Birthday Shader 2025 - startup and frame trace
+
+    --trace FILE records where startup and every frame spend their
+    time. A TraceSpan marks a scope; spans go into a ring buffer
+    allocated up front, so recording never allocates or takes a lock,
+    from any thread. The first TRACE_KEEP_EVENTS (startup) are never
+    overwritten. GPU work is timed with GL_TIMESTAMP queries, read back
+    a few frames late and moved onto the same clock, so it shows as one
+    more thread under the CPU ones. On exit, and whenever T is pressed,
+    the buffer is written as Chrome trace JSON, which chrome://tracing
+    and ui.perfetto.dev open.
+*******************************************************************/
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <GL/glew.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+constexpr uint64_t TRACE_CAPACITY = 1 << 16;            // Events, about a minute of frames
+constexpr uint64_t TRACE_KEEP_EVENTS = 256;             // The ring only turns over after these
+constexpr uint32_t TRACE_GPU_QUERY_PAIRS = 32;          // GPU spans in flight
+constexpr double TRACE_GPU_CALIBRATE_SECONDS = 1.0;     // How often the GPU clock is lined up again
+constexpr uint32_t TRACE_GPU_THREAD = 0;
+
+class Tracer {
+public:
+    Tracer();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    // Nanoseconds since the tracer was made
+    int64_t now() const;
+
+    // Safe from any thread at any time
+    void record(const char* name, int64_t start, int64_t end, uint32_t thread);
+    void record(const char* name, int64_t start, int64_t end) { record(name, start, end, currentThread()); }
+
+    // Names what the calling thread shows up as
+    void nameThread(const char* name);
+
+    // Writes what the buffer holds right now; may run while other threads keep recording
+    bool write(const std::string& path, std::ostream& log) const;
+
+private:
+    // Fields are atomics only so a snapshot racing a writer is defined; all relaxed, sequence orders them
+    struct Event {
+        std::atomic<uint64_t> sequence{0};  // Index + 1 once complete, 0 while being written
+        std::atomic<const char*> name{nullptr};  // Always a string literal
+        std::atomic<int64_t> start{0};
+        std::atomic<int64_t> end{0};
+        std::atomic<uint32_t> thread{0};
+    };
+
+    uint32_t currentThread();
+    static uint64_t slot(uint64_t index);
+
+    std::chrono::steady_clock::time_point origin;
+    std::unique_ptr<Event[]> events;
+    std::atomic<uint64_t> next{0};
+    std::atomic<uint32_t> threadCount{TRACE_GPU_THREAD + 1};
+    mutable std::mutex nameMutex;
+    std::vector<std::pair<uint32_t, std::string>> threadNames;
+};
+
+// Records the scope it lives in; does nothing without a tracer
+class TraceSpan {
+public:
+    TraceSpan(Tracer* tracer, const char* name) : tracer(tracer), name(name), start(tracer ? tracer->now() : 0) {}
+    ~TraceSpan() { finish(); }
+
+    // Ends the span before the scope does
+    void finish() {
+        if (tracer) {
+            tracer->record(name, start, tracer->now());
+            tracer = nullptr;
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    Tracer* tracer;
+    const char* name;
+    int64_t start;
+};
+
+// GPU spans from GL_TIMESTAMP queries, on the thread that owns the context
+class GpuTrace {
+public:
+    GpuTrace() = default;
+    ~GpuTrace();
+
+    GpuTrace(const GpuTrace&) = delete;
+    GpuTrace& operator=(const GpuTrace&) = delete;
+
+    // Needs a current context
+    bool create(Tracer* tracer);
+    void destroy();
+
+    // Around GL commands; spans don't nest. Dropped while every query pair is still in flight
+    void begin(const char* name);
+    void end();
+
+    // Once per frame: hands finished spans to the tracer, never waits
+    void collect();
+
+private:
+    void calibrate();
+
+    struct Span {
+        GLuint queries[2] = { 0, 0 };
+        const char* name = nullptr;
+    };
+
+    Tracer* tracer = nullptr;
+    Span spans[TRACE_GPU_QUERY_PAIRS];
+    uint32_t issued = 0;                    // Spans begun
+    uint32_t collected = 0;                 // Spans handed to the tracer
+    bool open = false;
+    int64_t gpuToTracer = 0;                // Added to a GL_TIMESTAMP to get tracer time
+    int64_t lastCalibration = 0;
+};
+
+#endif // TRACE_H
@@ -0,0 +1,37 @@
+/*******************************************************************
+    Birthday Shader 2025 - messages between the window and the render thread
+*******************************************************************/
+#include "window_events.h"
+
+#include <algorithm>
+#include <cstdio>
+
+void InputLatency::applied(const WindowCommand& command) {
+    waiting.push_back(command.sent);
+}
+
+void InputLatency::presented() {
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& sent : waiting) {
+        milliseconds.push_back(std::chrono::duration<double, std::milli>(now - sent).count());
+    }
+    waiting.clear();
+}
+
+void InputLatency::report(std::ostream& out) const {
+    if (milliseconds.empty()) {
+        return;
+    }
+    std::vector<double> sorted = milliseconds;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double value : sorted) {
+        sum += value;
+    }
+    // Nearest rank
+    size_t p95 = std::max<size_t>(1, static_cast<size_t>(0.95 * sorted.size() + 0.999)) - 1;
+    char line[160];
+    snprintf(line, sizeof(line), "Input to present: %zu inputs, mean %.1f ms, p95 %.1f ms, max %.1f ms", sorted.size(),
+             sum / sorted.size(), sorted[std::min(p95, sorted.size() - 1)], sorted.back());
+    out << line << std::endl;
+}
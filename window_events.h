@@ -0,0 +1,69 @@
+/*******************************************************************
+    Birthday Shader 2025 - messages between the window and the render thread
+
+    The render thread owns the GL context and draws continuously; the
+    main thread only runs GLFW's event loop, as GLFW requires. Key and
+    resize callbacks no longer touch any render state themselves: they
+    post a WindowCommand and the render thread applies it before its
+    next frame. Things only the main thread may do to the window (its
+    title) go back the other way. Each command carries the time of the
+    input, so the render thread can also measure how long an input
+    takes to reach the screen.
+*******************************************************************/
+#ifndef WINDOW_EVENTS_H
+#define WINDOW_EVENTS_H
+
+#include "spsc_queue.h"
+
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+constexpr size_t WINDOW_COMMAND_QUEUE_SIZE = 256;
+constexpr size_t WINDOW_TITLE_QUEUE_SIZE = 16;
+
+enum WindowCommandType {
+    COMMAND_RESIZE,                         // New framebuffer size in width x height
+    COMMAND_REPLAY,                         // Space
+    COMMAND_RESET,                          // R: vsync, dynamic resolution, FPS display and the animation
+    COMMAND_TOGGLE_VSYNC,                   // V
+    COMMAND_TOGGLE_DYNAMIC_RESOLUTION,      // D
+    COMMAND_TOGGLE_FPS,                     // S
+    COMMAND_FOCUS_GAINED,
+    COMMAND_FOCUS_LOST,
+    COMMAND_ICONIFIED,
+    COMMAND_RESTORED                        // No longer iconified
+};
+
+struct WindowCommand {
+    WindowCommandType type;
+    int width;
+    int height;
+    std::chrono::steady_clock::time_point sent;
+};
+
+struct WindowTitle {
+    char text[256];
+};
+
+typedef SpscQueue<WindowCommand, WINDOW_COMMAND_QUEUE_SIZE> WindowCommandQueue;   // Main thread -> render thread
+typedef SpscQueue<WindowTitle, WINDOW_TITLE_QUEUE_SIZE> WindowTitleQueue;         // Render thread -> main thread
+
+// Input-to-present latency, all on the render thread: from a command's input to the return of
+// glfwSwapBuffers() for the first frame drawn after applying it
+class InputLatency {
+public:
+    // A command applied to the frame about to be drawn
+    void applied(const WindowCommand& command);
+
+    // That frame has been handed to the display
+    void presented();
+
+    void report(std::ostream& out) const;
+
+private:
+    std::vector<std::chrono::steady_clock::time_point> waiting;
+    std::vector<double> milliseconds;
+};
+
+#endif // WINDOW_EVENTS_H
@@ -1,4 +1,9 @@
+cl /EHsc /MD /O2 /Fe:embed_files.exe embed_files.cpp shader_include.cpp
+embed_files.exe embedded_data.h birthday.shader birthday.letters birthday.timeline
 cl /EHsc /MD /Fe:birthdayshader_c.exe birthdayshader.c ^
+  animation.cpp animation_block.cpp antialias.cpp background_layer.cpp birthday_renderer.cpp embedded_files.cpp ^
+  gl_common.cpp letter_atlas.cpp letter_shader.cpp letter_tiles.cpp letters.cpp precision.cpp ^
+  program_cache.cpp scene.cpp shader_include.cpp shader_program.cpp trace.cpp ^
   /I"E:\Dev\glfw-3.4.bin.WIN64\include" ^
   /I"E:\Dev\glew-2.1.0-win32\include" ^
   /link ^
@@ -1,7 +1,15 @@
-cl /EHsc /MD /Fe:birthdayshader.exe birthdayshader.cpp ^
+cl /EHsc /MD /O2 /Fe:embed_files.exe embed_files.cpp shader_include.cpp
+embed_files.exe embedded_data.h birthday.shader birthday.letters birthday.timeline
+cl /EHsc /MD /O2 /Fe:birthdayshader.exe ^
+  animation.cpp animation_block.cpp antialias.cpp background_layer.cpp batch.cpp bench.cpp birthdayshader.cpp ^
+  cpu_renderer.cpp cpu_renderer_avx2.cpp dynamic_resolution.cpp embedded_files.cpp frame_export.cpp ^
+  frame_pacer.cpp gl_common.cpp headless.cpp image_io.cpp letter_atlas.cpp letter_shader.cpp letter_tiles.cpp ^
+  letters.cpp mirror.cpp precision.cpp profile.cpp program_cache.cpp scene.cpp shader_include.cpp shader_program.cpp ^
+  shader_reload.cpp telemetry.cpp thread_pool.cpp trace.cpp window_events.cpp ^
   /I"E:\Dev\glfw-3.4.bin.WIN64\include" ^
   /I"E:\Dev\glew-2.1.0-win32\include" ^
   /link ^
   /LIBPATH:"E:\Dev\glfw-3.4.bin.WIN64\lib-vc2022" glfw3.lib ^
   /LIBPATH:"E:\Dev\glew-2.1.0-win32\lib\Release\x64" glew32.lib ^
   opengl32.lib gdi32.lib user32.lib shell32.lib
+cl /EHsc /MD /O2 /Fe:telemetry_reader.exe telemetry_reader.cpp telemetry.cpp